@@ -0,0 +1,67 @@
+#include "arena.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_ALIGN 8
+
+struct ArenaBlock {
+    ArenaBlock *next;
+    size_t size;
+};
+
+static void *arena_new_block(Arena *a, size_t size) {
+    ArenaBlock *block;
+    size_t header = (sizeof(ArenaBlock) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    if (size < ARENA_BLOCK_SIZE - header)
+        size = ARENA_BLOCK_SIZE - header;
+    block = malloc(header + size);
+    if (!block) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    block->next = a->head;
+    block->size = size;
+    a->allocated += header + size;
+    a->head = block;
+    a->ptr = (char *)block + header;
+    a->end = a->ptr + size;
+    return a->ptr;
+}
+
+void *arena_alloc(Arena *a, size_t size) {
+    char *p = (char *)(((uintptr_t)a->ptr + ARENA_ALIGN - 1) & ~(uintptr_t)(ARENA_ALIGN - 1));
+
+    if (p > a->end || (size_t)(a->end - p) < size)
+        p = arena_new_block(a, size);
+    a->ptr = p + size;
+    return p;
+}
+
+char *arena_strndup(Arena *a, const char *s, size_t len) {
+    char *p;
+
+    // Strings are packed back to back without padding
+    if ((size_t)(a->end - a->ptr) < len + 1)
+        arena_new_block(a, len + 1);
+    p = a->ptr;
+    memcpy(p, s, len);
+    p[len] = '\0';
+    a->ptr += len + 1;
+    return p;
+}
+
+void arena_free(Arena *a) {
+    ArenaBlock *block = a->head;
+
+    while (block) {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    a->head = NULL;
+    a->ptr = a->end = NULL;
+    a->allocated = 0;
+}
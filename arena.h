@@ -0,0 +1,23 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#define ARENA_BLOCK_SIZE (1 << 20)
+
+typedef struct ArenaBlock ArenaBlock;
+
+// Bump allocator: memory is handed out from large blocks and released all at once.
+// A zero-initialized Arena is ready to use.
+typedef struct {
+    ArenaBlock *head;
+    char *ptr;
+    char *end;
+    size_t allocated;       // bytes in all blocks, headers included
+} Arena;
+
+void *arena_alloc(Arena *a, size_t size);
+char *arena_strndup(Arena *a, const char *s, size_t len);
+void arena_free(Arena *a);
+
+#endif
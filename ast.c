@@ -0,0 +1,93 @@
+#include "ast.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define AST_INITIAL_NODES 1024
+
+NodeId ast_new(Ast *ast, AstKind kind, uint32_t line, NodeId a, NodeId b, NodeId c) {
+    AstNode *node;
+
+    if (ast->count == ast->capacity) {
+        ast->capacity = ast->capacity ? ast->capacity * 2 : AST_INITIAL_NODES;
+        ast->nodes = realloc(ast->nodes, (size_t)ast->capacity * sizeof(AstNode));
+        if (!ast->nodes) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+        if (ast->count == 0)
+            ast->count = 1;  // Node 0 is the null node
+    }
+    node = &ast->nodes[ast->count];
+    memset(node, 0, sizeof(*node));
+    node->kind = (uint8_t)kind;
+    node->line = line;
+    node->a = a;
+    node->b = b;
+    node->c = c;
+    return ast->count++;
+}
+
+NodeId ast_named(Ast *ast, AstKind kind, uint32_t line, SymbolId sym, NodeId a, NodeId b, NodeId c) {
+    NodeId id = ast_new(ast, kind, line, a, b, c);
+    ast_at(ast, id)->v.sym = sym;
+    return id;
+}
+
+NodeId ast_binary(Ast *ast, int op, NodeId left, NodeId right) {
+    NodeId id = ast_new(ast, AST_BINARY, ast_at(ast, left)->line, left, right, 0);
+    ast_at(ast, id)->op = (uint16_t)op;
+    return id;
+}
+
+NodeId ast_literal(Ast *ast, AstKind kind, uint32_t line, const char *text, uint32_t len) {
+    NodeId id = ast_new(ast, kind, line, 0, 0, 0);
+    char small[64];
+    char *buf = small;
+
+    // Lexemes may point into a mapped file and are not NUL-terminated; a
+    // long one is copied whole, since every digit counts
+    if (len >= sizeof(small)) {
+        buf = malloc((size_t)len + 1);
+        if (!buf) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+    }
+    memcpy(buf, text, len);
+    buf[len] = '\0';
+    if (kind == AST_INT)
+        ast_at(ast, id)->v.ival = strtoll(buf, NULL, 10);
+    else
+        ast_at(ast, id)->v.fval = strtod(buf, NULL);
+    if (buf != small)
+        free(buf);
+    return id;
+}
+
+NodeId ast_list(Ast *ast, NodeId item) {
+    return ast_new(ast, AST_LIST, item ? ast_at(ast, item)->line : 0, item, item, 0);
+}
+
+NodeId ast_append(Ast *ast, NodeId list, NodeId item) {
+    AstNode *l = ast_at(ast, list);
+
+    if (l->b)
+        ast_at(ast, l->b)->next = item;
+    else
+        l->a = item;
+    l->b = item;
+    return list;
+}
+
+// Drop all nodes but keep the storage for reuse
+void ast_clear(Ast *ast) {
+    if (ast->count)
+        ast->count = 1;
+}
+
+void ast_free(Ast *ast) {
+    free(ast->nodes);
+    ast->nodes = NULL;
+    ast->count = ast->capacity = 0;
+}
@@ -0,0 +1,83 @@
+#ifndef AST_H
+#define AST_H
+
+#include <stdint.h>
+#include "intern.h"
+
+typedef uint32_t NodeId;  // index into Ast.nodes, 0 means no node
+
+typedef enum {
+    AST_PROGRAM,    // a: class list, b: statement list
+    AST_CLASS,      // sym: name, a: base name list, b: member list
+    AST_FIELD,      // sym: name, a: type, b: first dimension, c: second dimension
+    AST_METHOD,     // sym: name, a: parameter list, b: return type, c: body list
+    AST_PARAM,      // sym: name, a: type, flags: AST_ARRAY
+    AST_TYPE,       // op: TYPE_*, sym: class name for TYPE_CLASS
+    AST_BLOCK,      // a: statement list
+    AST_DECL,       // sym: name, a: type, b: initializer, flags: AST_LOCAL
+    AST_ASSIGN,     // a: target (NAME, MEMBER or INDEX), b: value
+    AST_IF,         // a: condition, b: then, c: else
+    AST_WHILE,      // a: condition, b: body
+    AST_READ,       // a: target
+    AST_WRITE,      // a: value
+    AST_RETURN,     // a: value
+    AST_BINARY,     // op: operator token, a: left, b: right
+    AST_NOT,        // a: operand
+    AST_INT,        // v.ival
+    AST_FLOAT,      // v.fval
+    AST_STRING,     // sym: literal including the quotes
+    AST_NAME,       // sym
+    AST_MEMBER,     // a: object name, sym: member (ID DOT ID)
+    AST_INDEX,      // a: array name, b: first index, c: second index
+    AST_CALL,       // sym: callee, a: receiver name, b: argument list, op: CALL_*
+    AST_ERROR,      // stands in for a construct skipped by error recovery
+    AST_LIST        // a: first item, b: last item; items are chained by next
+} AstKind;
+
+enum { TYPE_INTEGER, TYPE_FLOAT, TYPE_VOID, TYPE_CLASS };
+enum { CALL_FUNCTION, CALL_METHOD, CALL_SCOPED };
+
+#define AST_PUBLIC  0x01
+#define AST_PRIVATE 0x02
+#define AST_LOCAL   0x04
+#define AST_ARRAY   0x08
+
+// 32-byte node; children are indices, so the tree is one flat array
+typedef struct {
+    uint8_t kind;
+    uint8_t flags;
+    uint16_t op;
+    uint32_t line;
+    NodeId a, b, c;
+    NodeId next;
+    union {
+        int64_t ival;
+        double fval;
+        SymbolId sym;
+    } v;
+} AstNode;
+
+// All nodes of one file, allocated by bumping count and freed with one call
+typedef struct {
+    AstNode *nodes;
+    uint32_t count;
+    uint32_t capacity;
+} Ast;
+
+NodeId ast_new(Ast *ast, AstKind kind, uint32_t line, NodeId a, NodeId b, NodeId c);
+NodeId ast_named(Ast *ast, AstKind kind, uint32_t line, SymbolId sym, NodeId a, NodeId b, NodeId c);
+NodeId ast_binary(Ast *ast, int op, NodeId left, NodeId right);
+NodeId ast_literal(Ast *ast, AstKind kind, uint32_t line, const char *text, uint32_t len);
+NodeId ast_list(Ast *ast, NodeId item);
+NodeId ast_append(Ast *ast, NodeId list, NodeId item);
+void ast_clear(Ast *ast);
+void ast_free(Ast *ast);
+
+static inline AstNode *ast_at(const Ast *ast, NodeId id) {
+    return &ast->nodes[id];
+}
+
+#define AST_FOREACH(ast, list, id) \
+    for ((id) = (list) ? ast_at(ast, list)->a : 0; (id); (id) = ast_at(ast, id)->next)
+
+#endif
@@ -0,0 +1,308 @@
+// Synthetic corpus generator: writes a syntactically valid program of
+// roughly the requested size to stdout, for scanner and parser benchmarks.
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+    unsigned long long target;
+    int comment_pct;    // chance of a comment before a member or statement
+    int string_pct;     // chance a statement writes a string literal
+    int array2d_pct;    // chance an operand is a 2-D array access
+    int max_depth;      // nesting limit for while/if
+    int max_bases;      // length limit of isa lists
+} Mix;
+
+static unsigned long long rng_state = 88172645463325252ULL;
+static unsigned long long written;
+static char *out_buf;
+static size_t out_len;
+
+#define OUT_BUF_SIZE (1 << 20)
+
+static unsigned rnd(unsigned n) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 7;
+    rng_state ^= rng_state << 17;
+    return (unsigned)(rng_state % n);
+}
+
+static int chance(int pct) {
+    return (int)rnd(100) < pct;
+}
+
+static void emit(const char *fmt, ...) __attribute__((format(printf, 1, 2)));
+
+static void emit(const char *fmt, ...) {
+    va_list ap;
+    int n;
+
+    if (out_len + 4096 > OUT_BUF_SIZE) {
+        fwrite(out_buf, 1, out_len, stdout);
+        out_len = 0;
+    }
+    va_start(ap, fmt);
+    n = vsnprintf(out_buf + out_len, 4096, fmt, ap);
+    va_end(ap);
+    out_len += (size_t)n;
+    written += (unsigned long long)n;
+}
+
+static int indent_width = 4;   // spaces per nesting level
+
+static void indent(int level) {
+    emit("%*s", level * indent_width, "");
+}
+
+static const char *words[] = {
+    "count", "value", "total", "sum", "index", "limit", "result", "offset",
+    "step", "scale", "width", "height", "depth", "speed", "ratio", "delta"
+};
+#define NWORDS (sizeof(words) / sizeof(words[0]))
+
+static void comment(const Mix *mix, int level) {
+    if (!chance(mix->comment_pct))
+        return;
+    indent(level);
+    if (chance(50)) {
+        emit("// %s is updated before %s\n", words[rnd(NWORDS)], words[rnd(NWORDS)]);
+    } else {
+        emit("/* %s and %s\n", words[rnd(NWORDS)], words[rnd(NWORDS)]);
+        indent(level);
+        emit(" * keep %s within %s */\n", words[rnd(NWORDS)], words[rnd(NWORDS)]);
+    }
+}
+
+// Integer expression over the method's counters and the class arrays
+static void int_expr(const Mix *mix, int depth, int counters) {
+    unsigned k = depth > 2 ? rnd(4) : rnd(7);
+    int c = (int)rnd((unsigned)counters);
+
+    if (k < 4 && chance(mix->array2d_pct))
+        k = 3;
+    switch (k) {
+    case 0: emit("i%d", c); break;
+    case 1: emit("%u", rnd(1000)); break;
+    case 2: emit("data[i%d]", c); break;
+    case 3: emit("grid[i%d][%u]", c, rnd(4)); break;
+    case 4:
+        int_expr(mix, depth + 1, counters);
+        emit(" %c ", "+-*"[rnd(3)]);
+        int_expr(mix, depth + 1, counters);
+        break;
+    case 5:
+        emit("(");
+        int_expr(mix, depth + 1, counters);
+        emit(" + %u)", rnd(100));
+        break;
+    default:
+        emit("%s", words[rnd(NWORDS)]);
+        break;
+    }
+}
+
+static void float_expr(const Mix *mix, int depth, int counters) {
+    switch (depth > 2 ? rnd(2) : rnd(4)) {
+    case 0: emit("x"); break;
+    case 1: emit("%u.%u", rnd(100), rnd(1000)); break;
+    case 2:
+        emit("x * ");
+        float_expr(mix, depth + 1, counters);
+        break;
+    default:
+        emit("values[i%d] / %u.5e-%u", (int)rnd((unsigned)counters), rnd(9) + 1, rnd(4));
+        break;
+    }
+}
+
+static void condition(const Mix *mix, int counters) {
+    static const char *rel[] = { "<", ">", "<=", ">=", "==", "<>" };
+
+    int_expr(mix, 2, counters);
+    emit(" %s ", rel[rnd(6)]);
+    int_expr(mix, 2, counters);
+    if (chance(25)) {
+        emit(chance(50) ? " and not (x < " : " or (x >= ");
+        float_expr(mix, 2, counters);
+        emit(")");
+    }
+}
+
+static void stmt_list(const Mix *mix, int level, int depth, int counters, int n);
+
+static void stmt(const Mix *mix, int level, int depth, int counters) {
+    unsigned k = rnd(depth < mix->max_depth ? 10 : 7);
+    int c = (int)rnd((unsigned)counters);
+
+    comment(mix, level);
+    indent(level);
+    if (chance(mix->string_pct)) {
+        emit("write(\"%s: \\\"%s\\\"\\t%u\");\n", words[rnd(NWORDS)], words[rnd(NWORDS)], rnd(100));
+        return;
+    }
+    switch (k) {
+    case 0:
+    case 1:
+        emit("i%d = ", c);
+        int_expr(mix, 0, counters);
+        emit(";\n");
+        break;
+    case 2:
+        emit("data[i%d] = ", c);
+        int_expr(mix, 0, counters);
+        emit(";\n");
+        break;
+    case 3:
+        emit("grid[i%d][%u] = ", c, rnd(4));
+        int_expr(mix, 1, counters);
+        emit(";\n");
+        break;
+    case 4:
+        emit("x := ");
+        float_expr(mix, 0, counters);
+        emit(";\n");
+        break;
+    case 5:
+        emit("write(");
+        int_expr(mix, 1, counters);
+        emit(");\n");
+        break;
+    case 6:
+        emit("read(data[i%d]);\n", c);
+        break;
+    case 7:
+    case 8:
+        // Counted loop on a fresh counter so nested loops terminate
+        if (counters < 8) {
+            emit("i%d = 0;\n", counters);
+            indent(level);
+            emit("while (i%d < %u) {\n", counters, rnd(10) + 1);
+            stmt_list(mix, level + 1, depth + 1, counters + 1, (int)rnd(4) + 1);
+            indent(level + 1);
+            emit("i%d = i%d + 1;\n", counters, counters);
+            indent(level);
+            emit("}\n");
+            break;
+        }
+        /* fall through */
+    default:
+        emit("if (");
+        condition(mix, counters);
+        emit(chance(50) ? ") then {\n" : ") {\n");
+        stmt_list(mix, level + 1, depth + 1, counters, (int)rnd(3) + 1);
+        indent(level);
+        if (chance(50)) {
+            emit("} else {\n");
+            stmt_list(mix, level + 1, depth + 1, counters, (int)rnd(3) + 1);
+            indent(level);
+        }
+        emit("}\n");
+        break;
+    }
+}
+
+static void stmt_list(const Mix *mix, int level, int depth, int counters, int n) {
+    while (n-- > 0)
+        stmt(mix, level, depth, counters);
+}
+
+static void method(const Mix *mix, int id) {
+    int i;
+
+    comment(mix, 1);
+    indent(1);
+    if (chance(50))
+        emit("func m%d(integer a, float b) : integer {\n", id);
+    else
+        emit("func m%d() : void {\n", id);
+    for (i = 0; i < 8; i++) {
+        indent(2);
+        emit("integer i%d;\n", i);
+    }
+    indent(2);
+    emit("local float x := 0.0;\n");
+    for (i = 0; i < 3; i++) {
+        indent(2);
+        emit("i%d = 0;\n", i);
+    }
+    stmt_list(mix, 2, 0, 3, (int)rnd(8) + 2);
+    indent(2);
+    emit("return i0;\n");
+    indent(1);
+    emit("}\n");
+}
+
+static void class_decl(const Mix *mix, int id) {
+    int nbases = id > 0 ? (int)rnd((unsigned)mix->max_bases + 1) : 0;
+    int i;
+
+    comment(mix, 0);
+    emit("class C%d", id);
+    // Bases are always earlier classes, so the hierarchy stays acyclic
+    for (i = 0; i < nbases; i++)
+        emit("%s C%u", i == 0 ? " isa" : ",", rnd((unsigned)id));
+    emit(" {\n");
+    indent(1);
+    emit("%sinteger data[10];\n", chance(30) ? "private " : "");
+    indent(1);
+    emit("float values[10];\n");
+    indent(1);
+    emit("integer grid[rows][4];\n");
+    for (i = 0; i < (int)NWORDS; i++) {
+        if (chance(25)) {
+            indent(1);
+            emit("%s %s;\n", chance(70) ? "integer" : "float", words[i]);
+        }
+    }
+    for (i = (int)rnd(4) + 1; i > 0; i--)
+        method(mix, (int)rnd(100));
+    emit("}\n\n");
+}
+
+static unsigned long long parse_size(const char *s) {
+    char *end;
+    unsigned long long n = strtoull(s, &end, 10);
+
+    switch (*end) {
+    case 'k': case 'K': return n << 10;
+    case 'm': case 'M': return n << 20;
+    case 'g': case 'G': return n << 30;
+    default: return n;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    Mix mix = { 1 << 20, 10, 10, 20, 3, 3 };
+    int opt;
+    int id;
+
+    while ((opt = getopt(argc, argv, "s:c:w:a:d:b:i:r:")) != -1) {
+        switch (opt) {
+        case 's': mix.target = parse_size(optarg); break;
+        case 'c': mix.comment_pct = atoi(optarg); break;
+        case 'w': mix.string_pct = atoi(optarg); break;
+        case 'a': mix.array2d_pct = atoi(optarg); break;
+        case 'd': mix.max_depth = atoi(optarg); break;
+        case 'b': mix.max_bases = atoi(optarg); break;
+        case 'i': indent_width = atoi(optarg); break;
+        case 'r': rng_state = strtoull(optarg, NULL, 10) * 2654435761ULL + 1; break;
+        default:
+            fprintf(stderr, "Usage: %s [-s size[K|M|G]] [-c comment%%] [-w string%%] "
+                    "[-a array2d%%] [-d depth] [-b bases] [-i indent] [-r seed]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    out_buf = malloc(OUT_BUF_SIZE);
+    if (!out_buf) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 1;
+    }
+    for (id = 0; written < mix.target; id++)
+        class_decl(&mix, id);
+    fwrite(out_buf, 1, out_len, stdout);
+    free(out_buf);
+    return 0;
+}
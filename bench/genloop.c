@@ -0,0 +1,159 @@
+// Loop program generator: writes a program whose main method runs one
+// hot loop for the requested number of iterations, for measuring how
+// fast programs execute.
+//
+//   loop   the ArrayProcessor loop of test3.txt, summing instead of writing
+//   arith  integer and float arithmetic on locals
+//   array  1-D and 2-D array reads and writes
+//   call   a method call per iteration
+//   const  arithmetic on constant locals and identities that fold away
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static void loop(unsigned long long n) {
+    printf("class ArrayProcessor {\n"
+           "    integer data[10];\n"
+           "    float values[5];\n"
+           "\n"
+           "    func main() : void {\n"
+           "        integer i;\n"
+           "        integer j;\n"
+           "        integer sum;\n"
+           "        i = 0;\n"
+           "        sum = 0;\n"
+           "        data[0] = 1;\n"
+           "        data[1] = data[0] + 5;\n"
+           "        while (i < %llu) {\n"
+           "            j = i - i / 10 * 10;\n"
+           "            if (data[j] > 0) {\n"
+           "                sum = sum + data[j];\n"
+           "            }\n"
+           "            i = i + 1;\n"
+           "        }\n"
+           "        write(sum);\n"
+           "    }\n"
+           "}\n", n);
+}
+
+static void arith(unsigned long long n) {
+    printf("class Arith {\n"
+           "    func main() : void {\n"
+           "        integer i;\n"
+           "        integer a;\n"
+           "        float x;\n"
+           "        i = 0;\n"
+           "        a = 1;\n"
+           "        x = 0.5;\n"
+           "        while (i < %llu) {\n"
+           "            a = a * 3 + i - a / 7;\n"
+           "            x = x * 0.999 + 1.5 - x / 4.0;\n"
+           "            i = i + 1;\n"
+           "        }\n"
+           "        write(a);\n"
+           "        write(x);\n"
+           "    }\n"
+           "}\n", n);
+}
+
+static void array(unsigned long long n) {
+    printf("class Arrays {\n"
+           "    integer data[64];\n"
+           "    float values[64];\n"
+           "    integer grid[rows][8];\n"
+           "\n"
+           "    func main() : void {\n"
+           "        integer i;\n"
+           "        integer j;\n"
+           "        i = 0;\n"
+           "        while (i < %llu) {\n"
+           "            j = i - i / 64 * 64;\n"
+           "            data[j] = data[j] + i;\n"
+           "            values[j] = values[j] + 0.5;\n"
+           "            grid[j / 8][j - j / 8 * 8] = data[j] - grid[j / 8][j - j / 8 * 8];\n"
+           "            i = i + 1;\n"
+           "        }\n"
+           "        write(data[5]);\n"
+           "        write(values[5]);\n"
+           "        write(grid[3][4]);\n"
+           "    }\n"
+           "}\n", n);
+}
+
+static void call(unsigned long long n) {
+    printf("class Calls {\n"
+           "    integer total;\n"
+           "\n"
+           "    func step(integer k) : integer {\n"
+           "        total = total + k;\n"
+           "        return total;\n"
+           "    }\n"
+           "\n"
+           "    func main() : void {\n"
+           "        integer i;\n"
+           "        integer t;\n"
+           "        i = 0;\n"
+           "        while (i < %llu) {\n"
+           "            t = step(i);\n"
+           "            i = i + 1;\n"
+           "        }\n"
+           "        write(t);\n"
+           "    }\n"
+           "}\n", n);
+}
+
+static void constant(unsigned long long n) {
+    printf("class Constants {\n"
+           "    func main() : void {\n"
+           "        integer width := 16 * 4;\n"
+           "        integer scale := width / 8 + 1;\n"
+           "        float rate := 1.5 * 2;\n"
+           "        integer i;\n"
+           "        integer a;\n"
+           "        float x;\n"
+           "        i = 0;\n"
+           "        a = 0;\n"
+           "        x = 0.0;\n"
+           "        while (i < %llu) {\n"
+           "            a = a + scale * width * 1 - (width - 0) / 2 + (3 + 4) * 0;\n"
+           "            x = x + rate * (width * 2) / 1.0;\n"
+           "            if (not not (scale > 2) and 1) then a = a - 1;\n"
+           "            i = i + 1;\n"
+           "        }\n"
+           "        write(a);\n"
+           "        write(x);\n"
+           "    }\n"
+           "}\n", n);
+}
+
+int main(int argc, char *argv[]) {
+    unsigned long long n = 1000000;
+    const char *kind = "loop";
+    int opt;
+
+    while ((opt = getopt(argc, argv, "n:k:")) != -1) {
+        switch (opt) {
+        case 'n': n = strtoull(optarg, NULL, 10); break;
+        case 'k': kind = optarg; break;
+        default:
+            fprintf(stderr, "Usage: %s [-n iterations] [-k loop|arith|array|call|const]\n", argv[0]);
+            return 1;
+        }
+    }
+    if (strcmp(kind, "loop") == 0)
+        loop(n);
+    else if (strcmp(kind, "arith") == 0)
+        arith(n);
+    else if (strcmp(kind, "array") == 0)
+        array(n);
+    else if (strcmp(kind, "call") == 0)
+        call(n);
+    else if (strcmp(kind, "const") == 0)
+        constant(n);
+    else {
+        fprintf(stderr, "Error: Unknown kind '%s'\n", kind);
+        return 1;
+    }
+    return 0;
+}
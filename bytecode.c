@@ -0,0 +1,802 @@
+#include "vm.h"
+#include "jit.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parser.tab.h"
+
+// Compiler from the tree of one method to register bytecode (see vm.h).
+// Every expression has a kind known at compile time, since locals,
+// parameters, fields and method results are declared integer or float,
+// so the bytecode needs no type tags. A method that uses anything the
+// compiler cannot type this way (class-typed locals or parameters,
+// strings outside write, untyped methods, names that do not resolve) is
+// left to the tree interpreter, which also reports its errors.
+//
+// Locals and parameters keep the frame slots the resolve pass gave them,
+// so a name is its register. Constants get registers after them, filled
+// on entry, and temporaries are allocated as a stack above those.
+// Conditions compile to branches: an integer comparison in an if or
+// while becomes one compare-and-branch instruction, and and/or/not only
+// route the jumps.
+
+#define KIND_NONE 0xff
+#define JUMP_END (-1)
+#define FIXED_CONSTS 3      // integer 0 and 1, float 0
+
+typedef struct {
+    Interp *in;
+    NodeId method;
+    uint32_t cls;           // class declaring the method
+    Insn *insns;
+    uint32_t *lines;
+    uint32_t len;
+    uint32_t capacity;
+    Word *consts;
+    uint32_t nconsts;
+    uint32_t max_consts;
+    uint32_t nlocals;
+    uint32_t top;           // temporaries in use
+    uint32_t max_top;
+    VmCallSite *sites;
+    uint32_t nsites;
+    uint32_t sites_capacity;
+    uint16_t int_zero, int_one, float_zero;
+    uint8_t *local_kinds;
+    int failed;
+} Compiler;
+
+static VmCode uncompiled;   // marks a method left to the tree interpreter
+
+#define AST (&c->in->ctx->ast)
+#define INFO(id) (c->in->info[id])
+
+static void *grow(void *p, size_t size) {
+    p = realloc(p, size ? size : 1);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static uint32_t emit(Compiler *c, int op, uint32_t a, uint32_t b, uint32_t cc, int32_t k, uint32_t line) {
+    Insn *insn;
+
+    if (c->len == c->capacity) {
+        c->capacity = c->capacity ? c->capacity * 2 : 64;
+        c->insns = grow(c->insns, c->capacity * sizeof(Insn));
+        c->lines = grow(c->lines, c->capacity * sizeof(uint32_t));
+    }
+    insn = &c->insns[c->len];
+    insn->op = (uint16_t)op;
+    insn->a = (uint16_t)a;
+    insn->b = (uint16_t)b;
+    insn->c = (uint16_t)cc;
+    insn->k = k;
+    c->lines[c->len] = line;
+    return c->len++;
+}
+
+static uint16_t temp(Compiler *c) {
+    uint32_t reg = c->nlocals + c->max_consts + c->top++;
+
+    if (c->top > c->max_top)
+        c->max_top = c->top;
+    if (reg >= VM_NO_REG) {
+        c->failed = 1;
+        return 0;
+    }
+    return (uint16_t)reg;
+}
+
+static uint16_t konst(Compiler *c, Word w) {
+    if (c->nconsts == c->max_consts) {
+        c->failed = 1;
+        return 0;
+    }
+    c->consts[c->nconsts] = w;
+    return (uint16_t)(c->nlocals + c->nconsts++);
+}
+
+// Jumps still waiting for their target are chained through k
+static void patch(Compiler *c, int32_t chain, uint32_t target) {
+    while (chain != JUMP_END) {
+        int32_t next = c->insns[chain].k;
+        c->insns[chain].k = (int32_t)target;
+        chain = next;
+    }
+}
+
+static void link_jump(Compiler *c, uint32_t pc, int32_t *chain) {
+    c->insns[pc].k = *chain;
+    *chain = (int32_t)pc;
+}
+
+// ---- kinds ----
+
+static int is_number(int kind) {
+    return kind == VAL_INT || kind == VAL_FLOAT;
+}
+
+static int kind_of_type(int type) {
+    return type == TYPE_INTEGER ? VAL_INT : type == TYPE_FLOAT ? VAL_FLOAT : KIND_NONE;
+}
+
+static int decl_kind(Compiler *c, NodeId decl) {
+    const AstNode *node = ast_at(AST, decl);
+
+    if (node->kind != AST_DECL && node->kind != AST_PARAM && node->kind != AST_FIELD)
+        return KIND_NONE;
+    if (interp_is_array(c->in, decl))
+        return VAL_ARRAY;
+    if (interp_decl_type(c->in, decl) == TYPE_CLASS)
+        return VAL_OBJECT;
+    return kind_of_type(interp_decl_type(c->in, decl));
+}
+
+// Class of the object in a field of the method's object, or CLASS_NONE;
+// bytecode reaches other objects only through fields
+static uint32_t field_class(Compiler *c, NodeId name) {
+    NodeId decl = INFO(name);
+
+    if (!decl || ast_at(AST, decl)->kind != AST_FIELD || decl_kind(c, decl) != VAL_OBJECT)
+        return CLASS_NONE;
+    return hierarchy_find(&c->in->classes, ast_at(AST, ast_at(AST, decl)->a)->v.sym);
+}
+
+// Method a call resolves to from where it is compiled, or 0
+static NodeId static_target(Compiler *c, const AstNode *node) {
+    uint32_t cls = c->cls;
+    NodeId method;
+
+    if (node->op == CALL_METHOD)
+        cls = field_class(c, node->a);
+    else if (node->op == CALL_SCOPED)
+        cls = hierarchy_find(&c->in->classes, ast_at(AST, node->a)->v.sym);
+    if (cls == CLASS_NONE)
+        return 0;
+    method = hierarchy_member(&c->in->classes, cls, node->v.sym);
+    return method && ast_at(AST, method)->kind == AST_METHOD ? method : 0;
+}
+
+// Kind a method returns, if declared integer or float
+static int result_kind(Compiler *c, NodeId method) {
+    return ast_at(AST, method)->b ? kind_of_type(interp_decl_type(c->in, method)) : KIND_NONE;
+}
+
+static int expr_kind(Compiler *c, NodeId expr) {
+    const AstNode *node = ast_at(AST, expr);
+    NodeId decl;
+    int l, r;
+
+    switch (node->kind) {
+    case AST_INT:
+        return VAL_INT;
+    case AST_FLOAT:
+        return VAL_FLOAT;
+    case AST_BINARY:
+        l = expr_kind(c, node->a);
+        r = expr_kind(c, node->b);
+        if (!is_number(l) || !is_number(r))
+            return KIND_NONE;
+        if (node->op == PLUS || node->op == MINUS || node->op == MULT || node->op == DIV)
+            return l == VAL_FLOAT || r == VAL_FLOAT ? VAL_FLOAT : VAL_INT;
+        return VAL_INT;
+    case AST_NOT:
+        return is_number(expr_kind(c, node->a)) ? VAL_INT : KIND_NONE;
+    case AST_NAME:
+        return INFO(expr) ? decl_kind(c, INFO(expr)) : KIND_NONE;
+    case AST_INDEX:
+        decl = INFO(node->a);
+        return decl && decl_kind(c, decl) == VAL_ARRAY ? kind_of_type(interp_decl_type(c->in, decl)) : KIND_NONE;
+    case AST_MEMBER:
+        if (field_class(c, node->a) == CLASS_NONE)
+            return KIND_NONE;
+        decl = hierarchy_member(&c->in->classes, field_class(c, node->a), node->v.sym);
+        return decl && ast_at(AST, decl)->kind == AST_FIELD && !ast_at(AST, decl)->b
+            ? kind_of_type(interp_decl_type(c->in, decl)) : KIND_NONE;
+    case AST_CALL:
+        decl = static_target(c, node);
+        return decl ? result_kind(c, decl) : KIND_NONE;
+    default:
+        return KIND_NONE;
+    }
+}
+
+// ---- expressions ----
+
+static uint16_t compile_expr(Compiler *c, NodeId expr, uint16_t want, int *kind);
+static void cond_jump(Compiler *c, NodeId expr, int when, int32_t *chain);
+
+static uint16_t dest(Compiler *c, uint16_t want) {
+    return want != VM_NO_REG ? want : temp(c);
+}
+
+static uint16_t move(Compiler *c, uint16_t want, uint16_t reg, uint32_t line) {
+    if (want == VM_NO_REG || want == reg)
+        return reg;
+    emit(c, VM_MOV, want, reg, 0, 0, line);
+    return want;
+}
+
+// reg, of kind from, as kind to
+static uint16_t coerce(Compiler *c, uint16_t reg, int from, int to, uint16_t want, uint32_t line) {
+    uint16_t dst;
+
+    if (from == to)
+        return move(c, want, reg, line);
+    if (!is_number(from) || !is_number(to)) {
+        c->failed = 1;
+        return reg;
+    }
+    dst = dest(c, want);
+    emit(c, to == VAL_FLOAT ? VM_I2F : VM_F2I, dst, reg, 0, 0, line);
+    return dst;
+}
+
+// Expression compiled to the kind of its destination
+static uint16_t compile_as(Compiler *c, NodeId expr, int to, uint16_t want) {
+    int kind = expr_kind(c, expr);
+    uint16_t reg = compile_expr(c, expr, kind == to ? want : VM_NO_REG, &kind);
+
+    return coerce(c, reg, kind, to, want, ast_at(AST, expr)->line);
+}
+
+// Register holding an array named by an AST_NAME
+static uint16_t array_of(Compiler *c, NodeId name) {
+    NodeId decl = INFO(name);
+    uint16_t dst;
+
+    if (!decl || decl_kind(c, decl) != VAL_ARRAY) {
+        c->failed = 1;
+        return 0;
+    }
+    if (ast_at(AST, decl)->kind == AST_PARAM)
+        return (uint16_t)INFO(decl);
+    dst = temp(c);
+    emit(c, VM_GETA, dst, 0, 0, (int32_t)INFO(decl), ast_at(AST, name)->line);
+    return dst;
+}
+
+// Integer register of an index; floats index by their integer part
+static uint16_t index_of(Compiler *c, NodeId expr) {
+    return compile_as(c, expr, VAL_INT, VM_NO_REG);
+}
+
+static uint16_t compile_call(Compiler *c, NodeId expr, uint16_t want, int *kind) {
+    const AstNode *node = ast_at(AST, expr);
+    NodeId method = static_target(c, node);
+    VmCallSite *site;
+    uint32_t mark = c->top, nargs = 0, i;
+    uint16_t args;
+    NodeId arg, param = 0;
+    uint8_t *kinds;
+
+    *kind = method ? result_kind(c, method) : KIND_NONE;
+    if (!is_number(*kind)) {
+        c->failed = 1;
+        return 0;
+    }
+    AST_FOREACH(AST, node->b, arg)
+        nargs++;
+    kinds = grow(NULL, nargs);
+    args = (uint16_t)(c->nlocals + c->max_consts + c->top);
+    for (i = 0; i < nargs; i++)
+        temp(c);
+    i = 0;
+    if (ast_at(AST, method)->a)
+        param = ast_at(AST, ast_at(AST, method)->a)->a;
+    AST_FOREACH(AST, node->b, arg) {
+        int k = expr_kind(c, arg);
+        // arguments are converted to their parameters' types on entry
+        if (!param || (k == VAL_ARRAY) != (decl_kind(c, param) == VAL_ARRAY) || (k != VAL_ARRAY && !is_number(k)))
+            c->failed = 1;
+        compile_expr(c, arg, (uint16_t)(args + i), &k);
+        kinds[i++] = (uint8_t)k;
+        param = param ? ast_at(AST, param)->next : 0;
+    }
+    if (param)
+        c->failed = 1;
+    if (c->nsites == c->sites_capacity) {
+        c->sites_capacity = c->sites_capacity ? c->sites_capacity * 2 : 8;
+        c->sites = grow(c->sites, c->sites_capacity * sizeof(VmCallSite));
+    }
+    site = &c->sites[c->nsites];
+    site->call = expr;
+    site->args = args;
+    site->nargs = (uint16_t)nargs;
+    site->result = (uint8_t)*kind;
+    site->kinds = kinds;
+    c->top = mark;
+    want = dest(c, want);
+    emit(c, VM_CALL, want, 0, 0, (int32_t)c->nsites++, node->line);
+    return want;
+}
+
+static int compare_op(int op, int kind) {
+    int base = kind == VAL_FLOAT ? VM_LTF : VM_LTI;
+
+    switch (op) {
+    case LT: return base;
+    case GT: return base + 1;
+    case LE: return base + 2;
+    case GE: return base + 3;
+    case EQ: return base + 4;
+    default: return base + 5;
+    }
+}
+
+static uint16_t compile_binary(Compiler *c, NodeId expr, uint16_t want, int *kind) {
+    const AstNode *node = ast_at(AST, expr);
+    uint32_t mark = c->top;
+    uint16_t l, r, dst;
+    int lk, rk, k, op;
+
+    if (node->op == AND || node->op == OR) {
+        int32_t chain = JUMP_END;
+        uint32_t skip;
+
+        // the operands may read the destination, so it is set only at the end
+        dst = temp(c);
+        cond_jump(c, expr, 0, &chain);
+        emit(c, VM_MOV, dst, c->int_one, 0, 0, node->line);
+        skip = emit(c, VM_JMP, 0, 0, 0, 0, node->line);
+        patch(c, chain, c->len);
+        emit(c, VM_MOV, dst, c->int_zero, 0, 0, node->line);
+        c->insns[skip].k = (int32_t)c->len;
+        *kind = VAL_INT;
+        return move(c, want, dst, node->line);
+    }
+    l = compile_expr(c, node->a, VM_NO_REG, &lk);
+    r = compile_expr(c, node->b, VM_NO_REG, &rk);
+    if (!is_number(lk) || !is_number(rk)) {
+        c->failed = 1;
+        return 0;
+    }
+    k = lk == VAL_FLOAT || rk == VAL_FLOAT ? VAL_FLOAT : VAL_INT;
+    l = coerce(c, l, lk, k, VM_NO_REG, node->line);
+    r = coerce(c, r, rk, k, VM_NO_REG, node->line);
+    switch (node->op) {
+    case PLUS: op = k == VAL_FLOAT ? VM_ADDF : VM_ADDI; break;
+    case MINUS: op = k == VAL_FLOAT ? VM_SUBF : VM_SUBI; break;
+    case MULT: op = k == VAL_FLOAT ? VM_MULF : VM_MULI; break;
+    case DIV: op = k == VAL_FLOAT ? VM_DIVF : VM_DIVI; break;
+    default:
+        op = compare_op(node->op, k);
+        k = VAL_INT;
+        break;
+    }
+    c->top = mark;
+    dst = dest(c, want);
+    emit(c, op, dst, l, r, 0, node->line);
+    *kind = k;
+    return dst;
+}
+
+// Register holding the value of expr, in want if that is not VM_NO_REG
+static uint16_t compile_expr(Compiler *c, NodeId expr, uint16_t want, int *kind) {
+    const AstNode *node = ast_at(AST, expr);
+    uint32_t mark = c->top;
+    NodeId decl;
+    uint16_t dst, arr, row, col;
+    Word w;
+    int k;
+
+    *kind = KIND_NONE;
+    switch (node->kind) {
+    case AST_INT:
+        w.i = node->v.ival;
+        *kind = VAL_INT;
+        return move(c, want, konst(c, w), node->line);
+    case AST_FLOAT:
+        w.f = node->v.fval;
+        *kind = VAL_FLOAT;
+        return move(c, want, konst(c, w), node->line);
+    case AST_BINARY:
+        return compile_binary(c, expr, want, kind);
+    case AST_NOT:
+        dst = compile_expr(c, node->a, VM_NO_REG, &k);
+        if (!is_number(k))
+            break;
+        c->top = mark;
+        want = dest(c, want);
+        emit(c, k == VAL_FLOAT ? VM_EQF : VM_EQI, want, dst, k == VAL_FLOAT ? c->float_zero : c->int_zero, 0, node->line);
+        *kind = VAL_INT;
+        return want;
+    case AST_NAME:
+        decl = INFO(expr);
+        k = decl ? decl_kind(c, decl) : KIND_NONE;
+        if (k == VAL_ARRAY) {
+            *kind = k;
+            return move(c, want, array_of(c, expr), node->line);
+        }
+        if (!is_number(k))
+            break;
+        *kind = k;
+        if (ast_at(AST, decl)->kind != AST_FIELD)
+            return move(c, want, (uint16_t)INFO(decl), node->line);
+        want = dest(c, want);
+        emit(c, VM_GETF, want, 0, 0, (int32_t)INFO(decl), node->line);
+        return want;
+    case AST_INDEX:
+        k = expr_kind(c, expr);
+        if (!is_number(k))
+            break;
+        row = index_of(c, node->b);
+        col = node->c ? index_of(c, node->c) : 0;
+        arr = array_of(c, node->a);
+        c->top = mark;
+        want = dest(c, want);
+        emit(c, node->c ? VM_AGET2 : VM_AGET, want, arr, row, col, node->line);
+        *kind = k;
+        return want;
+    case AST_MEMBER:
+        k = expr_kind(c, expr);
+        if (!is_number(k))
+            break;
+        want = dest(c, want);
+        emit(c, VM_MGET, want, 0, (uint32_t)k, (int32_t)expr, node->line);
+        *kind = k;
+        return want;
+    case AST_CALL:
+        return compile_call(c, expr, want, kind);
+    default:
+        break;
+    }
+    c->failed = 1;
+    return 0;
+}
+
+// Jumps to chain when the truth of expr is when, else falls through
+static void cond_jump(Compiler *c, NodeId expr, int when, int32_t *chain) {
+    const AstNode *node = ast_at(AST, expr);
+    uint32_t mark = c->top;
+    int32_t other = JUMP_END;
+    uint16_t reg;
+    int kind;
+
+    if (node->kind == AST_NOT) {
+        cond_jump(c, node->a, !when, chain);
+        return;
+    }
+    if (node->kind == AST_BINARY && (node->op == AND || node->op == OR)) {
+        // a and b is true when both are; a or b when either is
+        if ((node->op == OR) == when) {
+            cond_jump(c, node->a, when, chain);
+            cond_jump(c, node->b, when, chain);
+        } else {
+            cond_jump(c, node->a, !when, &other);
+            cond_jump(c, node->b, when, chain);
+            patch(c, other, c->len);
+        }
+        return;
+    }
+    if (node->kind == AST_BINARY && node->op != PLUS && node->op != MINUS && node->op != MULT && node->op != DIV &&
+        expr_kind(c, node->a) == VAL_INT && expr_kind(c, node->b) == VAL_INT) {
+        static const int negate[] = { VM_BGEI, VM_BLEI, VM_BGTI, VM_BLTI, VM_BNEI, VM_BEQI };
+        int branch = compare_op(node->op, VAL_INT) - VM_LTI;
+        uint16_t l = compile_expr(c, node->a, VM_NO_REG, &kind);
+        uint16_t r = compile_expr(c, node->b, VM_NO_REG, &kind);
+
+        link_jump(c, emit(c, when ? VM_BLTI + branch : negate[branch], l, r, 0, 0, node->line), chain);
+        c->top = mark;
+        return;
+    }
+    reg = compile_expr(c, expr, VM_NO_REG, &kind);
+    if (kind == VAL_FLOAT) {
+        uint16_t t = temp(c);
+        emit(c, VM_NEF, t, reg, c->float_zero, 0, node->line);
+        reg = t;
+    } else if (kind != VAL_INT) {
+        c->failed = 1;
+    }
+    link_jump(c, emit(c, when ? VM_JNZ : VM_JZ, reg, 0, 0, 0, node->line), chain);
+    c->top = mark;
+}
+
+// ---- statements ----
+
+static void compile_stmt(Compiler *c, NodeId stmt);
+
+static void compile_list(Compiler *c, NodeId list) {
+    NodeId id;
+
+    AST_FOREACH(AST, list, id)
+        compile_stmt(c, id);
+}
+
+// Stores reg of kind into the target of an assignment or read
+static void store(Compiler *c, NodeId target, uint16_t reg, int kind) {
+    const AstNode *node = ast_at(AST, target);
+    NodeId decl = node->kind == AST_MEMBER ? 0 : INFO(node->kind == AST_INDEX ? node->a : target);
+    uint16_t arr, row, col;
+
+    switch (node->kind) {
+    case AST_NAME:
+        if (ast_at(AST, decl)->kind == AST_FIELD)
+            emit(c, kind == VAL_FLOAT ? VM_SETFF : VM_SETFI, 0, reg, 0, (int32_t)INFO(decl), node->line);
+        else
+            move(c, (uint16_t)INFO(decl), reg, node->line);
+        break;
+    case AST_INDEX:
+        row = index_of(c, node->b);
+        col = node->c ? index_of(c, node->c) : 0;
+        arr = array_of(c, node->a);
+        if (node->c)
+            emit(c, kind == VAL_FLOAT ? VM_ASET2F : VM_ASET2I, arr, row, col, reg, node->line);
+        else
+            emit(c, kind == VAL_FLOAT ? VM_ASETF : VM_ASETI, arr, row, reg, 0, node->line);
+        break;
+    case AST_MEMBER:
+        emit(c, VM_MSET, 0, reg, (uint32_t)kind, (int32_t)target, node->line);
+        break;
+    default:
+        c->failed = 1;
+        break;
+    }
+}
+
+static void compile_assign(Compiler *c, const AstNode *node) {
+    const AstNode *target = ast_at(AST, node->a);
+    int kind = expr_kind(c, node->a);
+    uint16_t reg;
+
+    if (!is_number(kind)) {
+        c->failed = 1;
+        return;
+    }
+    // a local is computed in place
+    if (target->kind == AST_NAME && ast_at(AST, INFO(node->a))->kind != AST_FIELD)
+        compile_as(c, node->b, kind, (uint16_t)INFO(INFO(node->a)));
+    else {
+        reg = compile_as(c, node->b, kind, VM_NO_REG);
+        store(c, node->a, reg, kind);
+    }
+}
+
+static void compile_stmt(Compiler *c, NodeId stmt) {
+    const AstNode *node = ast_at(AST, stmt);
+    int32_t chain = JUMP_END;
+    uint32_t top, jump;
+    uint16_t reg;
+    int kind;
+
+    c->top = 0;
+    switch (node->kind) {
+    case AST_DECL:
+        kind = decl_kind(c, stmt);
+        c->local_kinds[INFO(stmt)] = (uint8_t)kind;
+        if (!is_number(kind))
+            c->failed = 1;
+        else if (node->b)
+            compile_as(c, node->b, kind, (uint16_t)INFO(stmt));
+        else
+            emit(c, VM_MOV, INFO(stmt), kind == VAL_FLOAT ? c->float_zero : c->int_zero, 0, 0, node->line);
+        break;
+    case AST_BLOCK:
+        compile_list(c, node->a);
+        break;
+    case AST_ASSIGN:
+        compile_assign(c, node);
+        break;
+    case AST_IF:
+        cond_jump(c, node->a, 0, &chain);
+        compile_stmt(c, node->b);
+        if (node->c) {
+            jump = emit(c, VM_JMP, 0, 0, 0, 0, node->line);
+            patch(c, chain, c->len);
+            compile_stmt(c, node->c);
+            c->insns[jump].k = (int32_t)c->len;
+        } else {
+            patch(c, chain, c->len);
+        }
+        break;
+    case AST_WHILE:
+        // tested at the bottom, so an iteration takes one branch
+        jump = emit(c, VM_JMP, 0, 0, 0, 0, node->line);
+        top = c->len;
+        compile_stmt(c, node->b);
+        c->insns[jump].k = (int32_t)c->len;
+        c->top = 0;
+        cond_jump(c, node->a, 1, &chain);
+        patch(c, chain, top);
+        break;
+    case AST_READ:
+        kind = expr_kind(c, node->a);
+        if (!is_number(kind)) {
+            c->failed = 1;
+            break;
+        }
+        reg = temp(c);
+        emit(c, kind == VAL_FLOAT ? VM_READF : VM_READI, reg, 0, 0, 0, node->line);
+        store(c, node->a, reg, kind);
+        break;
+    case AST_WRITE:
+        if (ast_at(AST, node->a)->kind == AST_STRING) {
+            emit(c, VM_WRITES, 0, 0, 0, (int32_t)ast_at(AST, node->a)->v.sym, node->line);
+            break;
+        }
+        reg = compile_expr(c, node->a, VM_NO_REG, &kind);
+        if (!is_number(kind))
+            c->failed = 1;
+        emit(c, kind == VAL_FLOAT ? VM_WRITEF : VM_WRITEI, reg, 0, 0, 0, node->line);
+        break;
+    case AST_RETURN: {
+        // converted to the declared type; a method without one returns as is
+        int type = ast_at(AST, c->method)->b ? interp_decl_type(c->in, c->method) : TYPE_VOID;
+
+        if (type == TYPE_CLASS) {
+            c->failed = 1;
+            break;
+        }
+        kind = kind_of_type(type);
+        if (!node->a) {
+            emit(c, VM_RET, kind == VAL_FLOAT ? c->float_zero : c->int_zero, 0, kind == VAL_FLOAT ? VAL_FLOAT : VAL_INT, 0, node->line);
+            break;
+        }
+        if (kind == KIND_NONE)
+            kind = expr_kind(c, node->a);
+        if (!is_number(kind)) {
+            c->failed = 1;
+            break;
+        }
+        reg = compile_as(c, node->a, kind, VM_NO_REG);
+        emit(c, VM_RET, reg, 0, (uint32_t)kind, 0, node->line);
+        break;
+    }
+    default:
+        c->failed = 1;
+        break;
+    }
+}
+
+// ---- methods ----
+
+static uint32_t count_literals(Compiler *c, NodeId id) {
+    const AstNode *node;
+    uint32_t n = 0;
+    NodeId item;
+
+    if (!id)
+        return 0;
+    node = ast_at(AST, id);
+    switch (node->kind) {
+    case AST_INT:
+    case AST_FLOAT:
+        return 1;
+    case AST_LIST:
+        AST_FOREACH(AST, id, item)
+            n += count_literals(c, item);
+        return n;
+    case AST_TYPE:
+    case AST_NAME:
+    case AST_STRING:
+        return 0;
+    default:
+        return count_literals(c, node->a) + count_literals(c, node->b) + count_literals(c, node->c);
+    }
+}
+
+// Class whose member list holds the method
+static uint32_t owner(Interp *in, NodeId method) {
+    uint32_t i;
+    NodeId id;
+
+    for (i = 0; i < in->classes.count; i++) {
+        AST_FOREACH(&in->ctx->ast, ast_at(&in->ctx->ast, in->classes.classes[i].decl)->b, id) {
+            if (id == method)
+                return i;
+        }
+    }
+    return CLASS_NONE;
+}
+
+void vm_code_free(VmCode *code) {
+    uint32_t i;
+
+    if (!code || code == &uncompiled)
+        return;
+    for (i = 0; i < code->nsites; i++)
+        free(code->sites[i].kinds);
+    free(code->sites);
+    free(code->insns);
+    free(code->lines);
+    free(code->consts);
+    free(code->param_kinds);
+    free(code->param_types);
+    free(code->local_kinds);
+    jit_free(code);
+    free(code);
+}
+
+// Bytecode of a method, or NULL if it uses what the compiler leaves to the
+// tree interpreter
+VmCode *vm_compile(Interp *in, NodeId method) {
+    const AstNode *node = ast_at(&in->ctx->ast, method);
+    Compiler state;
+    Compiler *c = &state;
+    VmCode *code;
+    uint32_t nparams = 0, i;
+    NodeId param;
+    Word w;
+
+    memset(c, 0, sizeof(*c));
+    c->in = in;
+    c->method = method;
+    c->cls = owner(in, method);
+    c->nlocals = in->info[method];
+    c->max_consts = count_literals(c, node->c) + FIXED_CONSTS;
+    c->consts = grow(NULL, c->max_consts * sizeof(Word));
+    code = grow(NULL, sizeof(VmCode));
+    memset(code, 0, sizeof(*code));
+    AST_FOREACH(AST, node->a, param)
+        nparams++;
+    code->param_kinds = grow(NULL, nparams);
+    code->param_types = grow(NULL, nparams);
+    code->local_kinds = grow(NULL, c->nlocals);
+    memset(code->local_kinds, KIND_NONE, c->nlocals);
+    c->local_kinds = code->local_kinds;
+    i = 0;
+    AST_FOREACH(AST, node->a, param) {
+        int kind = decl_kind(c, param);
+        if (kind != VAL_ARRAY && !is_number(kind))
+            c->failed = 1;
+        code->param_kinds[i] = (uint8_t)kind;
+        code->local_kinds[i] = (uint8_t)kind;
+        code->param_types[i++] = (uint8_t)interp_decl_type(in, param);
+    }
+    w.i = 0;
+    c->int_zero = konst(c, w);
+    w.i = 1;
+    c->int_one = konst(c, w);
+    w.f = 0;
+    c->float_zero = konst(c, w);
+
+    if (c->cls == CLASS_NONE || c->nlocals + c->max_consts >= VM_NO_REG)
+        c->failed = 1;
+    else
+        compile_list(c, node->c);
+    emit(c, VM_RETV, 0, 0, 0, 0, node->line);
+
+    code->method = method;
+    code->insns = c->insns;
+    code->lines = c->lines;
+    code->len = c->len;
+    code->consts = c->consts;
+    code->nconsts = (uint16_t)c->nconsts;
+    code->nparams = (uint16_t)nparams;
+    code->nlocals = (uint16_t)c->nlocals;
+    code->nregs = (uint16_t)(c->nlocals + c->max_consts + c->max_top);
+    code->sites = c->sites;
+    code->nsites = c->nsites;
+    if (c->failed || c->nlocals + c->max_consts + c->max_top >= VM_NO_REG) {
+        vm_code_free(code);
+        return NULL;
+    }
+    return code;
+}
+
+// Compiled on first call and kept for the run
+VmCode *vm_code(Interp *in, NodeId method) {
+    VmCode *code = in->code[method];
+
+    if (!code) {
+        code = vm_compile(in, method);
+        in->code[method] = code = code ? code : &uncompiled;
+    }
+    return code == &uncompiled ? NULL : code;
+}
+
+// Arrays passed to a method must hold the element type its parameters
+// declare, since the bytecode reads elements without looking at their kind
+int vm_accepts(Interp *in, const VmCode *code, const Value *args) {
+    uint32_t i;
+
+    for (i = 0; i < code->nparams; i++) {
+        if (code->param_kinds[i] == VAL_ARRAY &&
+            (args[i].kind != VAL_ARRAY || interp_decl_type(in, args[i].v.arr->decl) != code->param_types[i]))
+            return 0;
+    }
+    return 1;
+}
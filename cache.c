@@ -0,0 +1,307 @@
+#include "cache.h"
+#include <errno.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "keywords.h"
+
+// Entry layout, integers as varints:
+//
+//   "PCAC" version(1) source_size parsed
+//   out_len out_text err_len err_text
+//   tokens-bin stream with an empty path (see emit_tokens_bin)
+
+#define P1 11400714785074694791ULL
+#define P2 14029467366897019727ULL
+#define P3 1609587929392839161ULL
+#define P4 9650029242287828579ULL
+#define P5 2870177450012600261ULL
+
+static uint64_t rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint64_t mix_round(uint64_t acc, uint64_t input) {
+    acc += input * P2;
+    return rotl(acc, 31) * P1;
+}
+
+static uint64_t merge_round(uint64_t acc, uint64_t v) {
+    acc ^= mix_round(0, v);
+    return acc * P1 + P4;
+}
+
+// XXH64: four independent lanes over 32-byte stripes, several GB/s
+static uint64_t hash64(const void *data, size_t len, uint64_t seed) {
+    const uint8_t *p = data;
+    const uint8_t *end = p + len;
+    uint64_t h;
+
+    if (len >= 32) {
+        uint64_t v1 = seed + P1 + P2, v2 = seed + P2, v3 = seed, v4 = seed - P1;
+        do {
+            v1 = mix_round(v1, read64(p));
+            v2 = mix_round(v2, read64(p + 8));
+            v3 = mix_round(v3, read64(p + 16));
+            v4 = mix_round(v4, read64(p + 24));
+            p += 32;
+        } while (end - p >= 32);
+        h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+        h = merge_round(h, v1);
+        h = merge_round(h, v2);
+        h = merge_round(h, v3);
+        h = merge_round(h, v4);
+    } else {
+        h = seed + P5;
+    }
+    h += (uint64_t)len;
+    for (; end - p >= 8; p += 8)
+        h = rotl(h ^ mix_round(0, read64(p)), 27) * P1 + P4;
+    if (end - p >= 4) {
+        h = rotl(h ^ (uint64_t)read32(p) * P1, 23) * P2 + P3;
+        p += 4;
+    }
+    for (; p < end; p++)
+        h = rotl(h ^ *p * P5, 11) * P1;
+    h ^= h >> 33;
+    h *= P2;
+    h ^= h >> 29;
+    h *= P3;
+    return h ^ (h >> 32);
+}
+
+static void entry_path(const Cache *cache, uint64_t key, char *path, size_t size) {
+    snprintf(path, size, "%s/%016llx", cache->dir, (unsigned long long)key);
+}
+
+// Everything that changes a report goes into the seed
+int cache_init(Cache *cache, const char *dir, int max_errors, int check) {
+    char settings[64];
+    struct stat st;
+    int n;
+
+    if (mkdir(dir, 0777) != 0 && errno != EEXIST)
+        return -1;
+    if (stat(dir, &st) != 0 || !S_ISDIR(st.st_mode))
+        return -1;
+    n = snprintf(settings, sizeof(settings), "%s max-errors=%d%s", PARSER_VERSION, max_errors,
+                 check ? " check" : "");
+    cache->dir = dir;
+    cache->seed = hash64(settings, (size_t)n, 0);
+    return 0;
+}
+
+int cache_key(const Cache *cache, const char *path, uint64_t *key, uint64_t *size) {
+    SourceMap map = {0};
+
+    if (source_map_open(&map, path) != 0)
+        return -1;
+    *key = hash64(map.base, map.size, cache->seed);
+    *size = map.size;
+    source_map_close(&map);
+    return 0;
+}
+
+static int read_varint(const uint8_t **p, const uint8_t *end, uint64_t *value) {
+    uint64_t v = 0;
+    int shift = 0;
+
+    while (*p < end && shift < 64) {
+        uint8_t byte = *(*p)++;
+        v |= (uint64_t)(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            *value = v;
+            return 0;
+        }
+        shift += 7;
+    }
+    return -1;
+}
+
+static int read_text(const uint8_t **p, const uint8_t *end, const char **text, size_t *len) {
+    uint64_t n;
+
+    if (read_varint(p, end, &n) != 0 || n > (uint64_t)(end - *p))
+        return -1;
+    *text = (const char *)*p;
+    *len = (size_t)n;
+    *p += n;
+    return 0;
+}
+
+// Maps the entry for key and checks all of it, so emitting it cannot fail
+// halfway through a report
+static int parse_entry(CacheEntry *entry, uint64_t size) {
+    const uint8_t *p = (const uint8_t *)entry->map.base;
+    const uint8_t *end = p + entry->map.size;
+    uint64_t v, count, n, i;
+    const char *text;
+    size_t len;
+
+    if (entry->map.size < 5 || memcmp(p, "PCAC\1", 5) != 0)
+        return -1;
+    p += 5;
+    if (read_varint(&p, end, &v) != 0 || v != size)
+        return -1;
+    if (read_varint(&p, end, &v) != 0)
+        return -1;
+    entry->parsed = v != 0;
+    if (read_text(&p, end, &entry->out_text, &entry->out_len) != 0 ||
+        read_text(&p, end, &entry->err_text, &entry->err_len) != 0)
+        return -1;
+
+    if (end - p < 5 || memcmp(p, TOKENS_BIN_MAGIC, 5) != 0)
+        return -1;
+    p += 5;
+    if (read_text(&p, end, &text, &len) != 0 || len != 0 || read_varint(&p, end, &v) != 0)
+        return -1;
+    entry->body = p;
+    if (read_varint(&p, end, &count) != 0 || count > (uint64_t)(end - p) || count > UINT32_MAX)
+        return -1;
+    entry->string_count = (uint32_t)count;
+    entry->strings = malloc((size_t)(count ? count : 1) * sizeof(char *));
+    entry->lengths = malloc((size_t)(count ? count : 1) * sizeof(uint32_t));
+    if (!entry->strings || !entry->lengths)
+        return -1;
+    for (i = 0; i < count; i++) {
+        if (read_text(&p, end, &text, &len) != 0 || len > UINT32_MAX)
+            return -1;
+        entry->strings[i] = text;
+        entry->lengths[i] = (uint32_t)len;
+    }
+
+    if (read_varint(&p, end, &n) != 0)
+        return -1;
+    entry->token_count = (size_t)n;
+    entry->tokens = p;
+    for (i = 0; i < n; i++) {
+        uint64_t kind, lexeme, offset, delta, column;
+        if (read_varint(&p, end, &kind) != 0 || read_varint(&p, end, &lexeme) != 0 ||
+            read_varint(&p, end, &offset) != 0 || read_varint(&p, end, &delta) != 0 ||
+            read_varint(&p, end, &column) != 0)
+            return -1;
+        // Type names were interned first, so a kind is a token_types index
+        if (kind >= (uint64_t)token_type_count || kind >= count || lexeme >= count)
+            return -1;
+    }
+    entry->end = p;
+    return p == end ? 0 : -1;
+}
+
+int cache_load(const Cache *cache, uint64_t key, uint64_t size, CacheEntry *entry) {
+    char path[PATH_MAX];
+
+    memset(entry, 0, sizeof(*entry));
+    entry_path(cache, key, path, sizeof(path));
+    if (source_map_open(&entry->map, path) != 0)
+        return -1;
+    if (parse_entry(entry, size) != 0) {
+        cache_entry_close(entry);
+        return -1;
+    }
+    return 0;
+}
+
+// The token part of a report, as print_symbol_table or the token dumps
+// would write it for the original parse
+void cache_emit(const CacheEntry *entry, Emitter *e, EmitFormat format, const char *path) {
+    const uint8_t *p = entry->tokens;
+    size_t path_len = strlen(path);
+    int line = 1;
+    size_t i;
+
+    if (format == EMIT_TOKENS_BIN) {
+        emit_bytes(e, TOKENS_BIN_MAGIC, 5);
+        emit_varint(e, path_len);
+        emit_bytes(e, path, path_len);
+        emit_varint(e, (uint64_t)entry->parsed);
+        emit_bytes(e, (const char *)entry->body, (size_t)(entry->end - entry->body));
+        return;
+    }
+    if (format == EMIT_TABLE)
+        emit_table_header(e);
+    else
+        emit_ndjson_header(e, path, entry->parsed, entry->token_count);
+    for (i = 0; i < entry->token_count; i++) {
+        uint64_t kind, lexeme, offset, delta, column;
+        // parse_entry already checked every token; stop rather than index
+        // the tables with a value that was never read
+        if (read_varint(&p, entry->end, &kind) != 0 || read_varint(&p, entry->end, &lexeme) != 0 ||
+            read_varint(&p, entry->end, &offset) != 0 || read_varint(&p, entry->end, &delta) != 0 ||
+            read_varint(&p, entry->end, &column) != 0)
+            break;
+        line += (int)delta;
+        if (format == EMIT_TABLE)
+            emit_table_row(e, entry->strings[lexeme], entry->lengths[lexeme], token_types[kind].name,
+                           line, (int)column);
+        else
+            emit_ndjson_row(e, entry->strings[lexeme], entry->lengths[lexeme], entry->strings[kind],
+                            entry->lengths[kind], line, (int)column);
+    }
+    if (format == EMIT_TABLE)
+        emit_table_footer(e);
+}
+
+void cache_entry_close(CacheEntry *entry) {
+    free(entry->strings);
+    free(entry->lengths);
+    entry->strings = NULL;
+    entry->lengths = NULL;
+    source_map_close(&entry->map);
+}
+
+// Written to a temporary file and renamed into place, so concurrent runs
+// never see a partial entry
+int cache_store(const Cache *cache, uint64_t key, uint64_t size, int parsed,
+                const char *out_text, size_t out_len, const char *err_text, size_t err_len,
+                const TokenStore *ts, const LineIndex *lines) {
+    char tmp[PATH_MAX], path[PATH_MAX];
+    Emitter e;
+    FILE *f;
+    int fd, ok;
+
+    snprintf(tmp, sizeof(tmp), "%s/.tmp-XXXXXX", cache->dir);
+    fd = mkstemp(tmp);
+    if (fd < 0)
+        return -1;
+    f = fdopen(fd, "wb");
+    if (!f) {
+        close(fd);
+        unlink(tmp);
+        return -1;
+    }
+    emitter_init(&e, f);
+    emit_bytes(&e, "PCAC\1", 5);
+    emit_varint(&e, size);
+    emit_varint(&e, parsed != 0);
+    emit_varint(&e, out_len);
+    emit_bytes(&e, out_text, out_len);
+    emit_varint(&e, err_len);
+    emit_bytes(&e, err_text, err_len);
+    emit_tokens_bin(&e, ts, lines, "", parsed);
+    emitter_free(&e);
+    ok = !ferror(f);
+    if (fclose(f) != 0)
+        ok = 0;
+    entry_path(cache, key, path, sizeof(path));
+    if (!ok || rename(tmp, path) != 0) {
+        unlink(tmp);
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "emit.h"
+#include "lines.h"
+#include "source.h"
+#include "tokens.h"
+
+// Part of every cache key; bump it whenever a change to the scanner,
+// grammar or reports changes what a parse prints
+#define PARSER_VERSION "parser 18"
+
+// On-disk cache of parse results, one file per entry in dir. An entry is
+// named after a hash of the source contents, the parser version and the
+// settings that affect the report, and holds the parse outcome, the
+// diagnostics and the token stream in tokens-bin form.
+typedef struct {
+    const char *dir;
+    uint64_t seed;          // hash of the version and settings
+} Cache;
+
+// A mapped cache entry; the pointers refer into the mapping
+typedef struct {
+    SourceMap map;
+    int parsed;
+    const char *out_text;   // what the parse printed to its report
+    size_t out_len;
+    const char *err_text;   // and to its diagnostics
+    size_t err_len;
+    const uint8_t *body;    // tokens-bin after the path and outcome
+    const uint8_t *tokens;  // token records within body
+    const uint8_t *end;
+    const char **strings;   // string table, by id
+    uint32_t *lengths;
+    uint32_t string_count;
+    size_t token_count;
+} CacheEntry;
+
+int cache_init(Cache *cache, const char *dir, int max_errors, int check);
+int cache_key(const Cache *cache, const char *path, uint64_t *key, uint64_t *size);
+int cache_load(const Cache *cache, uint64_t key, uint64_t size, CacheEntry *entry);
+void cache_emit(const CacheEntry *entry, Emitter *e, EmitFormat format, const char *path);
+void cache_entry_close(CacheEntry *entry);
+int cache_store(const Cache *cache, uint64_t key, uint64_t size, int parsed,
+                const char *out_text, size_t out_len, const char *err_text, size_t err_len,
+                const TokenStore *ts, const LineIndex *lines);
+
+#endif
@@ -0,0 +1,1419 @@
+#include "cgen.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "parser.tab.h"
+#include "runtime.h"
+
+// Translation of a parsed program to C, for --emit=c. Names are bound by
+// the interpreter's resolve pass (interp_init), so the C program does what
+// --run does, down to the runtime errors and their messages.
+//
+// Every class becomes a struct of the fields of its layout, bases first,
+// with an array whose size is a literal inline and an array whose first
+// dimension is a name as rows that grow when indexed. Every method becomes
+// a function for each class of self it is called on, and for each mix of
+// integer and float arrays its array parameters are given, so that fields,
+// calls and elements inside it resolve at translation time; only the
+// methods reachable from the entry are written. Integers are int64_t with
+// wrapping arithmetic, floats are double, and read and write use stdio
+// with a fully buffered stdout.
+//
+// Types stay static where the interpreter checks them as it runs. Errors
+// that depend only on types become a call to rt_error where the
+// interpreter would report them. What would give a variable a value of
+// another type, such as an object of another class, is not translated.
+
+#define KIND_VOID 0xff
+
+#define AST (&g->in->ctx->ast)
+#define NAME(sym) (int)intern_len(&g->in->ctx->symbol_table.strings, (sym)), \
+                  intern_str(&g->in->ctx->symbol_table.strings, (sym))
+
+typedef struct {
+    char *s;                // NUL-terminated once anything is put
+    size_t len;
+    size_t capacity;
+} Text;
+
+#define T(t) ((t).s ? (t).s : "")
+
+// A translated expression
+typedef struct {
+    Text text;
+    uint8_t kind;           // VAL_*, or KIND_VOID for a call to a method without a type
+    uint8_t pure;           // cannot fail or have effects, so it may run out of order
+    uint8_t failed;         // stops the program with an error when reached
+    uint32_t cls;           // of an object, CLASS_NONE if its class is not declared
+    NodeId decl;            // of an array, its field or parameter; of a void call, the method
+    SymbolId sym;           // of a string
+} Val;
+
+typedef struct {
+    uint32_t self;          // class of self
+    NodeId method;
+    uint32_t floats;        // array parameters given float arrays, by position
+} Instance;
+
+typedef struct {
+    Interp *in;
+    Instance *instances;    // functions to write, added as calls reach them
+    uint32_t ninstances;
+    uint32_t instances_capacity;
+    uint32_t self;          // of the function being written, CLASS_NONE for bare statements
+    NodeId method;          // 0 for bare statements
+    uint32_t floats;        // of the function being written
+    Text temps;             // declarations of its temporaries
+    uint32_t ntemps;
+    int errors;
+} Gen;
+
+static void *grow(void *p, size_t size) {
+    p = realloc(p, size ? size : 1);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static void put(Text *t, const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+
+static void put(Text *t, const char *fmt, ...) {
+    va_list ap;
+    int n;
+
+    for (;;) {
+        size_t room = t->capacity - t->len;
+        va_start(ap, fmt);
+        n = vsnprintf(t->s ? t->s + t->len : NULL, room, fmt, ap);
+        va_end(ap);
+        if ((size_t)n < room) {
+            t->len += (size_t)n;
+            return;
+        }
+        t->capacity = (t->len + (size_t)n + 1) * 2;
+        t->s = grow(t->s, t->capacity);
+    }
+}
+
+// A C string literal of len bytes
+static void quote(Text *t, const char *s, size_t len) {
+    size_t i;
+
+    put(t, "\"");
+    for (i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        if (c == '"' || c == '\\' || c == '?')
+            put(t, "\\%c", c);
+        else if (c == '\n')
+            put(t, "\\n");
+        else if (c == '\t')
+            put(t, "\\t");
+        else if (c >= 0x20 && c < 0x7f)
+            put(t, "%c", c);
+        else
+            put(t, "\\%03o", c);
+    }
+    put(t, "\"");
+}
+
+static void float_literal(Text *t, double f) {
+    char buf[64];
+
+    // Folded constants may be infinite or not a number
+    if (isinf(f)) {
+        put(t, signbit(f) ? "(-HUGE_VAL)" : "HUGE_VAL");
+        return;
+    }
+    if (isnan(f)) {
+        put(t, signbit(f) ? "(-NAN)" : "NAN");
+        return;
+    }
+    snprintf(buf, sizeof(buf), "%.17g", f);
+    put(t, strpbrk(buf, ".en") ? "%s" : "%s.0", buf);
+}
+
+static Val val(int kind) {
+    Val v;
+
+    memset(&v, 0, sizeof(v));
+    v.kind = (uint8_t)kind;
+    v.cls = CLASS_NONE;
+    return v;
+}
+
+static void release(Val *v) {
+    free(v->text.s);
+}
+
+static int is_number(const Val *v) {
+    return v->kind == VAL_INT || v->kind == VAL_FLOAT;
+}
+
+// A runtime error the interpreter reports here
+static Val fail(Gen *g, uint32_t line, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+static Val fail(Gen *g, uint32_t line, const char *fmt, ...) {
+    Val v = val(VAL_INT);
+    char msg[512];
+    va_list ap;
+
+    (void)g;
+    va_start(ap, fmt);
+    vsnprintf(msg, sizeof(msg), fmt, ap);
+    va_end(ap);
+    put(&v.text, "(rt_error(%u, \"%%s\", ", line);
+    quote(&v.text, msg, strlen(msg));
+    put(&v.text, "), INT64_C(0))");
+    v.failed = 1;
+    return v;
+}
+
+// What the translation leaves out; nothing is written in the end
+static void refuse(Gen *g, uint32_t line, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+
+static void refuse(Gen *g, uint32_t line, const char *fmt, ...) {
+    va_list ap;
+
+    fprintf(g->in->ctx->err, "Translation Error at line %u: ", line);
+    va_start(ap, fmt);
+    vfprintf(g->in->ctx->err, fmt, ap);
+    va_end(ap);
+    fputc('\n', g->in->ctx->err);
+    g->errors++;
+}
+
+// A stand-in for an expression refused
+static Val refused(void) {
+    Val v = val(VAL_INT);
+
+    put(&v.text, "INT64_C(0)");
+    v.failed = 1;
+    return v;
+}
+
+// before, for its effects, then v
+static Val then(Val before, Val v) {
+    Val r = v;
+
+    memset(&r.text, 0, sizeof(r.text));
+    put(&r.text, "((void)%s, %s)", T(before.text), T(v.text));
+    r.pure = 0;
+    release(&before);
+    release(&v);
+    return r;
+}
+
+static Val convert(Val v, int kind) {
+    Val r = v;
+
+    if (v.kind == kind)
+        return v;
+    memset(&r.text, 0, sizeof(r.text));
+    put(&r.text, kind == VAL_INT ? "((int64_t)%s)" : "((double)%s)", T(v.text));
+    r.kind = (uint8_t)kind;
+    release(&v);
+    return r;
+}
+
+static const char *type_name(int kind) {
+    return kind == VAL_INT ? "int64_t" : "double";
+}
+
+// ---- declarations ----
+
+static int kind_of_type(int type) {
+    return type == TYPE_INTEGER ? VAL_INT : type == TYPE_FLOAT ? VAL_FLOAT : type == TYPE_CLASS ? VAL_OBJECT : KIND_VOID;
+}
+
+// Class a type node names, CLASS_NONE if it is not declared
+static uint32_t class_of_type(Gen *g, NodeId type) {
+    return type && ast_at(AST, type)->op == TYPE_CLASS ? hierarchy_find(&g->in->classes, ast_at(AST, type)->v.sym)
+                                                       : CLASS_NONE;
+}
+
+static void struct_name(Gen *g, Text *t, uint32_t cls) {
+    put(t, "struct c%u_%.*s", cls, NAME(g->in->classes.classes[cls].name));
+}
+
+static void c_type(Gen *g, Text *t, int kind, uint32_t cls) {
+    if (kind == VAL_OBJECT && cls != CLASS_NONE) {
+        struct_name(g, t, cls);
+        put(t, " *");
+    } else {
+        put(t, "%s", kind == VAL_INT ? "int64_t" : kind == VAL_FLOAT ? "double" : kind == VAL_OBJECT ? "void *"
+                     : kind == VAL_ARRAY ? "RtRef" : "void");
+    }
+}
+
+// Value of a declaration's type: a parameter, local or field
+static Val typed(Gen *g, NodeId decl) {
+    Val v = val(interp_is_array(g->in, decl) ? VAL_ARRAY : kind_of_type(interp_decl_type(g->in, decl)));
+
+    v.decl = decl;
+    if (v.kind == VAL_OBJECT)
+        v.cls = class_of_type(g, ast_at(AST, decl)->a);
+    return v;
+}
+
+static void local_name(Gen *g, Text *t, NodeId decl) {
+    put(t, "v%u_%.*s", g->in->info[decl], NAME(ast_at(AST, decl)->v.sym));
+}
+
+// TYPE_* of the elements of an array. Those of a parameter are those of
+// the argument, whatever the parameter declares.
+static int element_type(Gen *g, NodeId decl) {
+    uint32_t i = 0;
+    NodeId param;
+
+    if (ast_at(AST, decl)->kind != AST_PARAM)
+        return interp_decl_type(g->in, decl);
+    AST_FOREACH(AST, ast_at(AST, g->method)->a, param) {
+        if (param == decl)
+            break;
+        i++;
+    }
+    return g->floats >> i & 1 ? TYPE_FLOAT : TYPE_INTEGER;
+}
+
+static void fn_name(Gen *g, Text *t, uint32_t index) {
+    const Instance *inst = &g->instances[index];
+
+    put(t, "m%u_%.*s_%.*s", index, NAME(g->in->classes.classes[inst->self].name),
+        NAME(ast_at(AST, inst->method)->v.sym));
+}
+
+// Function for method on self of class cls with the given array
+// arguments, queued the first time
+static uint32_t instance(Gen *g, uint32_t cls, NodeId method, uint32_t floats) {
+    uint32_t i;
+
+    for (i = 0; i < g->ninstances; i++) {
+        if (g->instances[i].self == cls && g->instances[i].method == method && g->instances[i].floats == floats)
+            return i;
+    }
+    if (g->ninstances == g->instances_capacity) {
+        g->instances_capacity = g->instances_capacity ? g->instances_capacity * 2 : 16;
+        g->instances = grow(g->instances, g->instances_capacity * sizeof(Instance));
+    }
+    g->instances[g->ninstances].self = cls;
+    g->instances[g->ninstances].method = method;
+    g->instances[g->ninstances].floats = floats;
+    return g->ninstances++;
+}
+
+static uint32_t temp(Gen *g, int kind, uint32_t cls) {
+    put(&g->temps, "    ");
+    c_type(g, &g->temps, kind, cls);
+    put(&g->temps, " t%u;\n", g->ntemps);
+    return g->ntemps++;
+}
+
+// C leaves the order of operands and arguments open, where the program
+// evaluates them left to right. An operand that could fail or have effects
+// goes to a temporary first if a later one could too. pre collects the
+// assignments, each ending in ", " for an expression, or as statements at
+// the given indent if that is not negative.
+static void order(Gen *g, Val *v, uint32_t n, Text *pre, int indent) {
+    uint32_t i, j, t;
+
+    for (i = 0; i + 1 < n; i++) {
+        int later = 0;
+
+        for (j = i + 1; j < n; j++)
+            later |= !v[j].pure;
+        if (v[i].pure || !later)
+            continue;
+        t = temp(g, v[i].kind, v[i].cls);
+        if (indent < 0)
+            put(pre, "t%u = %s, ", t, T(v[i].text));
+        else
+            put(pre, "%*st%u = %s;\n", indent, "", t, T(v[i].text));
+        v[i].text.len = 0;
+        put(&v[i].text, "t%u", t);
+        v[i].pure = 1;
+    }
+}
+
+// ---- expressions ----
+
+static Val expr(Gen *g, NodeId e);
+
+static Val field(Gen *g, const char *obj, uint32_t cls, NodeId decl, uint32_t line) {
+    int32_t slot = interp_layout(g->in, cls)->slot_of[g->in->info[decl]];
+    Val v;
+
+    if (slot < 0)
+        return fail(g, line, "an object of class '%.*s' has no field '%.*s'", NAME(g->in->classes.classes[cls].name),
+                    NAME(ast_at(AST, decl)->v.sym));
+    v = typed(g, decl);
+    put(&v.text, "%s->f%d_%.*s", obj, slot, NAME(ast_at(AST, decl)->v.sym));
+    v.pure = 1;
+    return v;
+}
+
+// Storage of the variable a NAME is bound to
+static Val variable(Gen *g, NodeId name) {
+    const AstNode *node = ast_at(AST, name);
+    NodeId decl = g->in->info[name];
+    Val v;
+
+    switch (decl ? ast_at(AST, decl)->kind : AST_ERROR) {
+    case AST_DECL:
+    case AST_PARAM:
+        v = typed(g, decl);
+        local_name(g, &v.text, decl);
+        v.pure = 1;
+        return v;
+    case AST_FIELD:
+        if (g->self != CLASS_NONE)
+            return field(g, "self", g->self, decl, node->line);
+        break;
+    case AST_METHOD:
+        return fail(g, node->line, "'%.*s' is not a variable", NAME(node->v.sym));
+    default:
+        break;
+    }
+    return fail(g, node->line, "'%.*s' is not declared", NAME(node->v.sym));
+}
+
+// Object a name refers to, made on first use as the interpreter does
+static Val receiver(Gen *g, NodeId name) {
+    const AstNode *node = ast_at(AST, name);
+    Val v = variable(g, name), r;
+
+    if (v.failed)
+        return v;
+    if (v.kind != VAL_OBJECT) {
+        release(&v);
+        return fail(g, node->line, "'%.*s' is not an object", NAME(node->v.sym));
+    }
+    if (v.cls == CLASS_NONE) {
+        release(&v);
+        return fail(g, node->line, "class '%.*s' is not declared",
+                    NAME(ast_at(AST, ast_at(AST, g->in->info[name])->a)->v.sym));
+    }
+    r = val(VAL_OBJECT);
+    r.cls = v.cls;
+    // Making it is a call, so two in one expression are not unsequenced
+    r.pure = 1;
+    put(&r.text, "o%u_%.*s(&%s)", v.cls, NAME(g->in->classes.classes[v.cls].name), T(v.text));
+    release(&v);
+    return r;
+}
+
+static Val member(Gen *g, NodeId e) {
+    const AstNode *node = ast_at(AST, e);
+    Val r = receiver(g, node->a), v;
+    NodeId decl;
+
+    if (r.failed)
+        return r;
+    decl = hierarchy_member(&g->in->classes, r.cls, node->v.sym);
+    if (!decl || ast_at(AST, decl)->kind != AST_FIELD) {
+        v = fail(g, node->line, "class '%.*s' has no field '%.*s'", NAME(g->in->classes.classes[r.cls].name),
+                 NAME(node->v.sym));
+    } else {
+        v = field(g, T(r.text), r.cls, decl, node->line);
+    }
+    release(&r);
+    return v;
+}
+
+// Index as the interpreter takes it: a float truncates
+static Val index_of(Gen *g, NodeId e) {
+    Val v = expr(g, e);
+
+    if (is_number(&v))
+        return convert(v, VAL_INT);
+    return then(v, fail(g, ast_at(AST, e)->line, "index is not a number"));
+}
+
+// Element of an INDEX, to read, or as an lvalue to write; the evaluation
+// of its indexes that has to come first is added to pre (see order)
+static Val element(Gen *g, NodeId e, int write, Text *pre, int indent) {
+    const AstNode *node = ast_at(AST, e);
+    const AstNode *name = ast_at(AST, node->a);
+    int used = node->c ? 2 : 1;
+    Val v[2], arr, r;
+    const AstNode *decl;
+    uint32_t rows = 0, cols = 0;
+    int kind, dims;
+
+    v[0] = index_of(g, node->b);
+    if (node->c) {
+        v[1] = index_of(g, node->c);
+    } else {
+        v[1] = val(VAL_INT);
+        put(&v[1].text, "0");
+        v[1].pure = 1;
+    }
+    arr = variable(g, node->a);
+    if (!arr.failed && arr.kind != VAL_ARRAY) {
+        release(&arr);
+        arr = fail(g, node->line, "'%.*s' is not an array", NAME(name->v.sym));
+    }
+    if (arr.failed)
+        return then(v[0], then(v[1], arr));
+    decl = ast_at(AST, arr.decl);
+    kind = kind_of_type(element_type(g, arr.decl));
+    if (kind != VAL_INT && kind != VAL_FLOAT) {
+        release(&v[0]);
+        release(&v[1]);
+        release(&arr);
+        refuse(g, node->line, "cannot translate arrays of objects");
+        return refused();
+    }
+    if (decl->kind == AST_FIELD) {
+        cols = decl->c ? (uint32_t)ast_at(AST, decl->c)->v.ival : 0;
+        rows = ast_at(AST, decl->b)->kind == AST_INT ? (uint32_t)ast_at(AST, decl->b)->v.ival : 0;
+        dims = cols ? 2 : 1;
+        if (used != dims) {
+            release(&arr);
+            return then(v[0], then(v[1], fail(g, node->line, "'%.*s' has %d dimensions but is indexed with %d",
+                                              NAME(decl->v.sym), dims, used)));
+        }
+    }
+    order(g, v, 2, pre, indent);
+    r = val(kind);
+    if (decl->kind == AST_PARAM && write)
+        put(&r.text, "*(%s *)rt_at(%s, sizeof(%s), %s, %s, %d, %u)", type_name(kind), T(arr.text),
+            type_name(kind), T(v[0].text), T(v[1].text), used, node->line);
+    else if (decl->kind == AST_PARAM)
+        put(&r.text, "rt_at_%c(%s, %s, %s, %d, %u)", kind == VAL_INT ? 'i' : 'f', T(arr.text), T(v[0].text),
+            T(v[1].text), used, node->line);
+    else if (ast_at(AST, decl->b)->kind == AST_INT)
+        put(&r.text, "%s[rt_index(%s, %s, %u, %u, %u, \"%.*s\")]", T(arr.text), T(v[0].text), T(v[1].text), rows,
+            cols, node->line, NAME(decl->v.sym));
+    else if (write)
+        put(&r.text, "*(%s *)rt_grow(&%s, sizeof(%s), %u, %s, %s, %u, \"%.*s\")", type_name(kind), T(arr.text),
+            type_name(kind), cols, T(v[0].text), T(v[1].text), node->line, NAME(decl->v.sym));
+    else
+        put(&r.text, "rt_get_%c(&%s, %u, %s, %s, %u, \"%.*s\")", kind == VAL_INT ? 'i' : 'f', T(arr.text), cols,
+            T(v[0].text), T(v[1].text), node->line, NAME(decl->v.sym));
+    release(&v[0]);
+    release(&v[1]);
+    release(&arr);
+    return r;
+}
+
+// Wraps an expression in the evaluation order put into pre
+static Val ordered(Val v, Text *pre) {
+    Val r = v;
+
+    if (!pre->len)
+        return v;
+    memset(&r.text, 0, sizeof(r.text));
+    put(&r.text, "(%s%s)", T(*pre), T(v.text));
+    release(&v);
+    free(pre->s);
+    return r;
+}
+
+static Val binary(Gen *g, NodeId e) {
+    const AstNode *node = ast_at(AST, e);
+    Val v[2], r;
+    Text pre = {0};
+    const char *op = "";
+    int ints, compare;
+
+    v[0] = expr(g, node->a);
+    v[1] = expr(g, node->b);
+    if (node->op == AND || node->op == OR) {
+        // The right operand only runs when it decides
+        if (!is_number(&v[0])) {
+            release(&v[1]);
+            return then(v[0], fail(g, node->line, "condition is not a number"));
+        }
+        if (!is_number(&v[1]))
+            v[1] = then(v[1], fail(g, node->line, "condition is not a number"));
+        r = val(VAL_INT);
+        r.pure = v[0].pure && v[1].pure;
+        put(&r.text, "((int64_t)(%s != 0 %s %s != 0))", T(v[0].text), node->op == AND ? "&&" : "||",
+            T(v[1].text));
+        release(&v[0]);
+        release(&v[1]);
+        return r;
+    }
+    if (!is_number(&v[0]) || !is_number(&v[1]))
+        return then(v[0], then(v[1], fail(g, node->line, "operands are not numbers")));
+    order(g, v, 2, &pre, -1);
+    ints = v[0].kind == VAL_INT && v[1].kind == VAL_INT;
+    compare = 0;
+    switch (node->op) {
+    case PLUS: op = "+"; break;
+    case MINUS: op = "-"; break;
+    case MULT: op = "*"; break;
+    case DIV: op = "/"; break;
+    case LT: op = "<"; compare = 1; break;
+    case GT: op = ">"; compare = 1; break;
+    case LE: op = "<="; compare = 1; break;
+    case GE: op = ">="; compare = 1; break;
+    case EQ: op = "=="; compare = 1; break;
+    case NE: op = "!="; compare = 1; break;
+    }
+    r = val(compare || ints ? VAL_INT : VAL_FLOAT);
+    r.pure = v[0].pure && v[1].pure && !(ints && node->op == DIV);
+    if (compare)
+        put(&r.text, "((int64_t)(%s %s %s))", T(v[0].text), op, T(v[1].text));
+    else if (ints && node->op == DIV)
+        put(&r.text, "rt_div(%s, %s, %u)", T(v[0].text), T(v[1].text), node->line);
+    else if (ints)
+        // Unsigned arithmetic wraps where signed would overflow
+        put(&r.text, "((int64_t)((uint64_t)%s %s (uint64_t)%s))", T(v[0].text), op, T(v[1].text));
+    else
+        put(&r.text, "((double)%s %s (double)%s)", T(v[0].text), op, T(v[1].text));
+    release(&v[0]);
+    release(&v[1]);
+    return ordered(r, &pre);
+}
+
+static int returns_value(Gen *g, NodeId list);
+
+static int stmt_returns_value(Gen *g, NodeId stmt) {
+    const AstNode *node = ast_at(AST, stmt);
+
+    switch (node->kind) {
+    case AST_RETURN:
+        return node->a != 0;
+    case AST_BLOCK:
+        return returns_value(g, node->a);
+    case AST_IF:
+        return stmt_returns_value(g, node->b) || (node->c && stmt_returns_value(g, node->c));
+    case AST_WHILE:
+        return stmt_returns_value(g, node->b);
+    default:
+        return 0;
+    }
+}
+
+static int returns_value(Gen *g, NodeId list) {
+    NodeId id;
+
+    AST_FOREACH(AST, list, id) {
+        if (stmt_returns_value(g, id))
+            return 1;
+    }
+    return 0;
+}
+
+static Val call(Gen *g, NodeId e) {
+    const AstNode *node = ast_at(AST, e);
+    uint32_t nargs = 0, cls = g->self, i, n, floats = 0;
+    NodeId method = 0, param, arg;
+    Val *v, r, bad;
+    Text pre = {0};
+    int kind, stopped;
+
+    r = val(VAL_OBJECT);
+    if (node->op == CALL_FUNCTION) {
+        if (g->self != CLASS_NONE)
+            method = hierarchy_member(&g->in->classes, g->self, node->v.sym);
+        put(&r.text, "self");
+        r.pure = 1;
+    } else if (node->op == CALL_METHOD) {
+        r = receiver(g, node->a);
+        if (r.failed)
+            return r;
+        cls = r.cls;
+        method = hierarchy_member(&g->in->classes, cls, node->v.sym);
+    } else {
+        uint32_t named = hierarchy_find(&g->in->classes, ast_at(AST, node->a)->v.sym);
+
+        if (named == CLASS_NONE) {
+            release(&r);
+            return fail(g, node->line, "class '%.*s' is not declared", NAME(ast_at(AST, node->a)->v.sym));
+        }
+        method = hierarchy_member(&g->in->classes, named, node->v.sym);
+        // Runs on self, or on a new object of the named class outside methods
+        if (g->self == CLASS_NONE) {
+            cls = named;
+            put(&r.text, "rt_new(sizeof(");
+            struct_name(g, &r.text, cls);
+            put(&r.text, "))");
+        } else {
+            put(&r.text, "self");
+        }
+        r.pure = 1;
+    }
+    if (!method || ast_at(AST, method)->kind != AST_METHOD) {
+        release(&r);
+        return fail(g, node->line, "no method '%.*s'", NAME(node->v.sym));
+    }
+    AST_FOREACH(AST, node->b, arg)
+        nargs++;
+    i = 0;
+    AST_FOREACH(AST, ast_at(AST, method)->a, param)
+        i++;
+    if (i != nargs) {
+        release(&r);
+        return fail(g, node->line, "'%.*s' takes %u arguments", NAME(ast_at(AST, method)->v.sym), i);
+    }
+
+    // Arguments take the types of the parameters once all are evaluated;
+    // one that stops the program ends the call there
+    v = grow(NULL, (nargs + 1) * sizeof(Val));
+    v[0] = r;
+    n = 1;
+    AST_FOREACH(AST, node->b, arg) {
+        if (n > 1 && v[n - 1].failed)
+            break;
+        v[n++] = expr(g, arg);
+    }
+    stopped = n > 1 && v[n - 1].failed;
+    bad = val(KIND_VOID);
+    i = 1;
+    AST_FOREACH(AST, ast_at(AST, method)->a, param) {
+        Val p = typed(g, param);
+        Val *a = &v[i++];
+
+        if (bad.kind != KIND_VOID || stopped)
+            break;
+        if (p.kind == VAL_ARRAY) {
+            if (a->kind != VAL_ARRAY) {
+                bad = fail(g, node->line, "argument '%.*s' is not an array", NAME(ast_at(AST, param)->v.sym));
+            } else if (i - 2 >= 32) {
+                refuse(g, node->line, "cannot translate passing an array after 32 parameters");
+                bad = refused();
+            } else {
+                if (element_type(g, a->decl) == TYPE_FLOAT)
+                    floats |= 1u << (i - 2);
+                if (ast_at(AST, a->decl)->kind == AST_FIELD) {
+                    const AstNode *decl = ast_at(AST, a->decl);
+                    Text ref = {0};
+                    uint32_t cols = decl->c ? (uint32_t)ast_at(AST, decl->c)->v.ival : 0;
+
+                    if (ast_at(AST, decl->b)->kind == AST_INT)
+                        put(&ref, "rt_ref(%s, NULL, %u, %u, \"%.*s\")", T(a->text),
+                            (uint32_t)ast_at(AST, decl->b)->v.ival, cols, NAME(decl->v.sym));
+                    else
+                        put(&ref, "rt_ref(NULL, &%s, 0, %u, \"%.*s\")", T(a->text), cols, NAME(decl->v.sym));
+                    release(a);
+                    a->text = ref;
+                }
+            }
+        } else if (p.kind == VAL_OBJECT) {
+            if (a->kind != VAL_OBJECT || a->cls != p.cls) {
+                refuse(g, node->line, "cannot translate passing this value as '%.*s'", NAME(ast_at(AST, param)->v.sym));
+                bad = refused();
+            }
+        } else if (!is_number(a)) {
+            bad = fail(g, node->line, "cannot store a %s in a number", a->kind == VAL_STRING ? "string" : "reference");
+        } else {
+            *a = convert(*a, p.kind);
+        }
+    }
+    if (stopped || bad.kind != KIND_VOID) {
+        r = stopped ? v[--n] : bad;
+        while (n-- > 1)
+            r = then(v[n], r);
+        release(&v[0]);
+        free(v);
+        return r;
+    }
+
+    order(g, v, nargs + 1, &pre, -1);
+    kind = kind_of_type(interp_decl_type(g->in, method));
+    r = val(kind);
+    r.decl = method;
+    if (kind == VAL_OBJECT)
+        r.cls = class_of_type(g, ast_at(AST, method)->b);
+    fn_name(g, &r.text, instance(g, cls, method, floats));
+    put(&r.text, "(%s, %u", T(v[0].text), node->line);
+    for (i = 1; i <= nargs; i++)
+        put(&r.text, ", %s", T(v[i].text));
+    put(&r.text, ")");
+    for (i = 0; i <= nargs; i++)
+        release(&v[i]);
+    free(v);
+    return ordered(r, &pre);
+}
+
+static Val expr(Gen *g, NodeId e) {
+    const AstNode *node = ast_at(AST, e);
+    Val v, r;
+    Text pre = {0};
+
+    switch (node->kind) {
+    case AST_INT:
+        v = val(VAL_INT);
+        // INT64_C(-9223372036854775808) would negate a constant too large
+        if (node->v.ival == INT64_MIN)
+            put(&v.text, "INT64_MIN");
+        else
+            put(&v.text, "INT64_C(%lld)", (long long)node->v.ival);
+        v.pure = 1;
+        return v;
+    case AST_FLOAT:
+        v = val(VAL_FLOAT);
+        float_literal(&v.text, node->v.fval);
+        v.pure = 1;
+        return v;
+    case AST_STRING:
+        v = val(VAL_STRING);
+        put(&v.text, "0");
+        v.sym = node->v.sym;
+        v.pure = 1;
+        return v;
+    case AST_BINARY:
+        return binary(g, e);
+    case AST_NOT:
+        v = expr(g, node->a);
+        if (!is_number(&v))
+            return then(v, fail(g, node->line, "condition is not a number"));
+        r = v;
+        memset(&r.text, 0, sizeof(r.text));
+        put(&r.text, "((int64_t)!%s)", T(v.text));
+        r.kind = VAL_INT;
+        release(&v);
+        return r;
+    case AST_NAME:
+        return variable(g, e);
+    case AST_MEMBER:
+        return member(g, e);
+    case AST_INDEX:
+        return ordered(element(g, e, 0, &pre, -1), &pre);
+    case AST_CALL:
+        v = call(g, e);
+        if (v.kind != KIND_VOID)
+            return v;
+        // A method without a type gives what its return gives, or 0
+        if (returns_value(g, ast_at(AST, v.decl)->c)) {
+            release(&v);
+            refuse(g, node->line, "cannot translate using the value of '%.*s', which has no type", NAME(node->v.sym));
+            return refused();
+        }
+        r = val(VAL_INT);
+        put(&r.text, "(%s, INT64_C(0))", T(v.text));
+        release(&v);
+        return r;
+    default:
+        refuse(g, node->line, "cannot translate this expression");
+        return refused();
+    }
+}
+
+// ---- statements ----
+
+static void stmt(Gen *g, Text *out, NodeId s, int indent);
+
+static void stmt_list(Gen *g, Text *out, NodeId list, int indent) {
+    NodeId id;
+
+    AST_FOREACH(AST, list, id)
+        stmt(g, out, id, indent);
+}
+
+// Body of an if or while, in braces either way
+static void branch(Gen *g, Text *out, NodeId s, int indent) {
+    if (ast_at(AST, s)->kind == AST_BLOCK)
+        stmt_list(g, out, ast_at(AST, s)->a, indent);
+    else
+        stmt(g, out, s, indent);
+}
+
+static Val condition(Gen *g, NodeId e, uint32_t line) {
+    Val v = expr(g, e);
+
+    return is_number(&v) ? v : then(v, fail(g, line, "condition is not a number"));
+}
+
+// target = v, converted to the target's type as the interpreter does
+static void store(Gen *g, Text *out, int indent, Val *target, Val v, uint32_t line) {
+    if (v.failed) {
+        put(out, "%*s(void)%s;\n", indent, "", T(v.text));
+        release(&v);
+        return;
+    }
+    if (target->kind == VAL_OBJECT) {
+        if (v.kind == VAL_OBJECT && v.cls == target->cls)
+            put(out, "%*s%s = %s;\n", indent, "", T(target->text), T(v.text));
+        else
+            refuse(g, line, "cannot translate storing this value in an object variable");
+        release(&v);
+        return;
+    }
+    if (target->kind == VAL_ARRAY) {
+        refuse(g, line, "cannot translate storing into a whole array");
+        release(&v);
+        return;
+    }
+    if (!is_number(&v))
+        v = then(v, fail(g, line, "cannot store a %s in a number", v.kind == VAL_STRING ? "string" : "reference"));
+    v = convert(v, target->kind);
+    put(out, "%*s%s = %s;\n", indent, "", T(target->text), T(v.text));
+    release(&v);
+}
+
+// Storage an assignment or read names, with the evaluation its indexes
+// need first put into pre
+static Val target(Gen *g, NodeId e, Text *pre, int indent) {
+    switch (ast_at(AST, e)->kind) {
+    case AST_NAME:
+        return variable(g, e);
+    case AST_MEMBER:
+        return member(g, e);
+    case AST_INDEX:
+        return element(g, e, 1, pre, indent);
+    default:
+        return fail(g, ast_at(AST, e)->line, "cannot assign to this expression");
+    }
+}
+
+// Escapes other than \n, \t and \r stand for the character itself
+static void write_string(Gen *g, Text *out, SymbolId sym) {
+    const char *s = intern_str(&g->in->ctx->symbol_table.strings, sym);
+    uint32_t len = intern_len(&g->in->ctx->symbol_table.strings, sym);
+    char *text = grow(NULL, len + 1);
+    uint32_t i, n = 0;
+
+    for (i = 1; i + 1 < len; i++) {
+        char c = s[i];
+        if (c == '\\' && i + 2 < len) {
+            c = s[++i];
+            c = c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c;
+        }
+        text[n++] = c;
+    }
+    text[n++] = '\n';
+    quote(out, text, n);
+    free(text);
+}
+
+static void stmt(Gen *g, Text *out, NodeId s, int indent) {
+    const AstNode *node = ast_at(AST, s);
+    int kind = g->method ? kind_of_type(interp_decl_type(g->in, g->method)) : KIND_VOID;
+    Text pre = {0};
+    Val v, lv;
+
+    switch (node->kind) {
+    case AST_DECL:
+        lv = typed(g, s);
+        local_name(g, &lv.text, s);
+        if (node->b)
+            store(g, out, indent, &lv, expr(g, node->b), node->line);
+        else
+            put(out, "%*s%s = %s;\n", indent, "", T(lv.text),
+                lv.kind == VAL_INT ? "0" : lv.kind == VAL_FLOAT ? "0.0" : "NULL");
+        release(&lv);
+        break;
+    case AST_BLOCK:
+        put(out, "%*s{\n", indent, "");
+        stmt_list(g, out, node->a, indent + 4);
+        put(out, "%*s}\n", indent, "");
+        break;
+    case AST_ASSIGN:
+        // The value comes first, then the place it goes to, which may
+        // make an object or evaluate indexes
+        v = expr(g, node->b);
+        if (v.failed) {
+            put(out, "%*s(void)%s;\n", indent, "", T(v.text));
+            release(&v);
+            break;
+        }
+        if (ast_at(AST, node->a)->kind != AST_NAME && !v.pure) {
+            uint32_t t = temp(g, v.kind, v.cls);
+            put(out, "%*st%u = %s;\n", indent, "", t, T(v.text));
+            v.text.len = 0;
+            put(&v.text, "t%u", t);
+            v.pure = 1;
+        }
+        lv = target(g, node->a, &pre, indent);
+        put(out, "%s", T(pre));
+        if (lv.failed) {
+            lv = then(v, lv);
+            put(out, "%*s(void)%s;\n", indent, "", T(lv.text));
+        } else {
+            store(g, out, indent, &lv, v, node->line);
+        }
+        free(pre.s);
+        release(&lv);
+        break;
+    case AST_IF:
+        v = condition(g, node->a, node->line);
+        put(out, "%*sif (%s) {\n", indent, "", T(v.text));
+        branch(g, out, node->b, indent + 4);
+        if (node->c) {
+            put(out, "%*s} else {\n", indent, "");
+            branch(g, out, node->c, indent + 4);
+        }
+        put(out, "%*s}\n", indent, "");
+        release(&v);
+        break;
+    case AST_WHILE:
+        v = condition(g, node->a, node->line);
+        put(out, "%*swhile (%s) {\n", indent, "", T(v.text));
+        branch(g, out, node->b, indent + 4);
+        put(out, "%*s}\n", indent, "");
+        release(&v);
+        break;
+    case AST_READ:
+        lv = target(g, node->a, &pre, indent);
+        put(out, "%s", T(pre));
+        if (lv.failed)
+            put(out, "%*s(void)%s;\n", indent, "", T(lv.text));
+        else if (lv.kind == VAL_INT || lv.kind == VAL_FLOAT)
+            put(out, "%*s%s = rt_read_%s();\n", indent, "", T(lv.text), lv.kind == VAL_INT ? "int" : "float");
+        else if (lv.kind == VAL_OBJECT)
+            put(out, "%*srt_error(%u, \"cannot read into an object\");\n", indent, "", node->line);
+        else
+            refuse(g, node->line, "cannot translate reading into a whole array");
+        free(pre.s);
+        release(&lv);
+        break;
+    case AST_WRITE:
+        v = expr(g, node->a);
+        if (v.kind == VAL_INT || v.kind == VAL_FLOAT) {
+            put(out, "%*srt_write_%s(%s);\n", indent, "", v.kind == VAL_INT ? "int" : "float", T(v.text));
+        } else if (v.kind == VAL_STRING) {
+            put(out, "%*sfputs(", indent, "");
+            write_string(g, out, v.sym);
+            put(out, ", stdout);\n");
+        } else {
+            v = then(v, fail(g, node->line, "cannot write an object or array"));
+            put(out, "%*s(void)%s;\n", indent, "", T(v.text));
+        }
+        release(&v);
+        break;
+    case AST_RETURN:
+        if (!g->method || kind == KIND_VOID) {
+            if (node->a) {
+                v = expr(g, node->a);
+                put(out, "%*s(void)%s;\n", indent, "", T(v.text));
+                release(&v);
+            }
+            if (g->method)
+                put(out, "%*srt_depth--;\n", indent, "");
+            put(out, "%*sreturn;\n", indent, "");
+        } else if (!node->a) {
+            put(out, "%*sreturn rt_ret_%c(%s);\n", indent, "", kind == VAL_OBJECT ? 'p' : kind == VAL_INT ? 'i' : 'f',
+                kind == VAL_OBJECT ? "NULL" : "0");
+        } else {
+            v = expr(g, node->a);
+            if (v.failed) {
+                put(out, "%*s(void)%s;\n", indent, "", T(v.text));
+            } else if (kind == VAL_OBJECT ? v.kind != VAL_OBJECT || v.cls != class_of_type(g, ast_at(AST, g->method)->b)
+                                          : !is_number(&v)) {
+                refuse(g, node->line, "cannot translate returning this value");
+            } else {
+                if (kind != VAL_OBJECT)
+                    v = convert(v, kind);
+                put(out, "%*sreturn rt_ret_%c(%s);\n", indent, "", kind == VAL_OBJECT ? 'p' : kind == VAL_INT ? 'i' : 'f',
+                    T(v.text));
+            }
+            release(&v);
+        }
+        break;
+    default:
+        refuse(g, node->line, "cannot translate this statement");
+        break;
+    }
+}
+
+// Locals are declared at the top, one per slot, and their declarations
+// assign them
+static void declare_locals(Gen *g, Text *out, NodeId s) {
+    const AstNode *node = ast_at(AST, s);
+    NodeId id;
+    Val v;
+
+    switch (node->kind) {
+    case AST_DECL:
+        v = typed(g, s);
+        put(out, "    ");
+        c_type(g, out, v.kind, v.cls);
+        put(out, " ");
+        local_name(g, out, s);
+        put(out, " = %s;\n", v.kind == VAL_INT ? "0" : v.kind == VAL_FLOAT ? "0.0" : "NULL");
+        break;
+    case AST_BLOCK:
+        AST_FOREACH(AST, node->a, id)
+            declare_locals(g, out, id);
+        break;
+    case AST_IF:
+        declare_locals(g, out, node->b);
+        if (node->c)
+            declare_locals(g, out, node->c);
+        break;
+    case AST_WHILE:
+        declare_locals(g, out, node->b);
+        break;
+    default:
+        break;
+    }
+}
+
+static void signature(Gen *g, Text *out, uint32_t index) {
+    const Instance *inst = &g->instances[index];
+    const AstNode *method = ast_at(AST, inst->method);
+    NodeId param;
+
+    put(out, "static ");
+    c_type(g, out, kind_of_type(interp_decl_type(g->in, inst->method)), class_of_type(g, method->b));
+    put(out, " ");
+    fn_name(g, out, index);
+    put(out, "(");
+    struct_name(g, out, inst->self);
+    put(out, " *self, int line");
+    AST_FOREACH(AST, method->a, param) {
+        Val p = typed(g, param);
+        put(out, ", ");
+        c_type(g, out, p.kind, p.cls);
+        put(out, " ");
+        local_name(g, out, param);
+    }
+    put(out, ")");
+}
+
+// Statements, with the locals and temporaries they need declared first
+static void function_body(Gen *g, Text *out, NodeId list, const char *entry) {
+    Text body = {0};
+    NodeId id;
+
+    g->temps.len = 0;
+    if (g->temps.s)
+        g->temps.s[0] = '\0';
+    g->ntemps = 0;
+    stmt_list(g, &body, list, 4);
+    AST_FOREACH(AST, list, id)
+        declare_locals(g, out, id);
+    put(out, "%s%s%s", T(g->temps), entry, T(body));
+    free(body.s);
+}
+
+static void write_instance(Gen *g, Text *out, uint32_t index) {
+    Instance inst = g->instances[index];
+    const AstNode *method = ast_at(AST, inst.method);
+    int kind = kind_of_type(interp_decl_type(g->in, inst.method));
+    uint32_t owner = CLASS_NONE, i;
+    NodeId id;
+
+    for (i = 0; i < g->in->classes.count && owner == CLASS_NONE; i++) {
+        AST_FOREACH(AST, ast_at(AST, g->in->classes.classes[i].decl)->b, id) {
+            if (id == inst.method)
+                owner = i;
+        }
+    }
+    put(out, "// %.*s.%.*s", NAME(g->in->classes.classes[owner].name), NAME(method->v.sym));
+    if (owner != inst.self)
+        put(out, " on a %.*s", NAME(g->in->classes.classes[inst.self].name));
+    put(out, "\n");
+    signature(g, out, index);
+    put(out, " {\n");
+    g->self = inst.self;
+    g->method = inst.method;
+    g->floats = inst.floats;
+    function_body(g, out, method->c, "    rt_enter(line);\n");
+    if (kind == KIND_VOID)
+        put(out, "    rt_depth--;\n");
+    else
+        put(out, "    return rt_ret_%c(%s);\n", kind == VAL_OBJECT ? 'p' : kind == VAL_INT ? 'i' : 'f',
+            kind == VAL_OBJECT ? "NULL" : "0");
+    put(out, "}\n\n");
+}
+
+static void write_struct(Gen *g, Text *out, uint32_t cls) {
+    const ClassLayout *l = interp_layout(g->in, cls);
+    uint32_t slot;
+
+    struct_name(g, out, cls);
+    put(out, " {\n");
+    if (!l->nslots)
+        put(out, "    char unused;\n");
+    for (slot = 0; slot < l->nslots; slot++) {
+        const AstNode *node = ast_at(AST, l->fields[slot]);
+        Val v = typed(g, l->fields[slot]);
+
+        put(out, "    ");
+        if (!node->b) {
+            c_type(g, out, v.kind, v.cls);
+            put(out, " f%u_%.*s;\n", slot, NAME(node->v.sym));
+        } else if (interp_decl_type(g->in, l->fields[slot]) == TYPE_CLASS) {
+            refuse(g, node->line, "cannot translate arrays of objects");
+        } else if (ast_at(AST, node->b)->kind == AST_INT) {
+            uint64_t n = (uint64_t)ast_at(AST, node->b)->v.ival * (node->c ? (uint64_t)ast_at(AST, node->c)->v.ival : 1);
+            put(out, "%s f%u_%.*s[%llu];\n", interp_decl_type(g->in, l->fields[slot]) == TYPE_FLOAT ? "double" : "int64_t",
+                slot, NAME(node->v.sym), (unsigned long long)(n ? n : 1));
+        } else {
+            put(out, "RtRows f%u_%.*s;\n", slot, NAME(node->v.sym));
+        }
+    }
+    put(out, "};\n\n");
+}
+
+// The runtime every translation starts with
+static const char prelude[] =
+    "#include <math.h>\n"
+    "#include <stdarg.h>\n"
+    "#include <stdint.h>\n"
+    "#include <stdio.h>\n"
+    "#include <stdlib.h>\n"
+    "#include <string.h>\n"
+    "\n"
+    "#if defined(__GNUC__)\n"
+    "#define RT_NORETURN __attribute__((noreturn))\n"
+    "#else\n"
+    "#define RT_NORETURN\n"
+    "#endif\n"
+    "\n"
+    "#define RT_MAX_CALLS 10000\n"
+    "#define RT_MAX_ROWS (1u << 24)\n"
+    "\n"
+    "// Array whose first dimension is a name: its rows grow as they are indexed\n"
+    "typedef struct { void *data; uint32_t rows; } RtRows;\n"
+    "// Array passed as an argument: fixed storage of n rows, or growing rows\n"
+    "typedef struct { void *fixed; RtRows *rows; uint32_t n, cols; const char *name; } RtRef;\n"
+    "\n"
+    "static int rt_depth;\n"
+    "\n"
+    "static RT_NORETURN void rt_error(int line, const char *fmt, ...) {\n"
+    "    va_list ap;\n"
+    "\n"
+    "    fflush(stdout);\n"
+    "    fprintf(stderr, \"Runtime Error at line %d: \", line);\n"
+    "    va_start(ap, fmt);\n"
+    "    vfprintf(stderr, fmt, ap);\n"
+    "    va_end(ap);\n"
+    "    fputc('\\n', stderr);\n"
+    "    exit(1);\n"
+    "}\n"
+    "\n"
+    "static RT_NORETURN void rt_range(int line, int64_t index, const char *name) {\n"
+    "    rt_error(line, \"index %lld is out of range for '%s'\", (long long)index, name);\n"
+    "}\n"
+    "\n"
+    "static inline void *rt_new(size_t size) {\n"
+    "    void *p = calloc(1, size);\n"
+    "\n"
+    "    if (!p) {\n"
+    "        fprintf(stderr, \"Error: Out of memory\\n\");\n"
+    "        exit(1);\n"
+    "    }\n"
+    "    return p;\n"
+    "}\n"
+    "\n"
+    "static inline void rt_enter(int line) {\n"
+    "    if (rt_depth == RT_MAX_CALLS)\n"
+    "        rt_error(line, \"calls nest too deeply\");\n"
+    "    rt_depth++;\n"
+    "}\n"
+    "\n"
+    "static inline int64_t rt_ret_i(int64_t v) { rt_depth--; return v; }\n"
+    "static inline double rt_ret_f(double v) { rt_depth--; return v; }\n"
+    "static inline void *rt_ret_p(void *v) { rt_depth--; return v; }\n"
+    "\n"
+    "static inline int64_t rt_div(int64_t a, int64_t b, int line) {\n"
+    "    if (b == 0)\n"
+    "        rt_error(line, \"division by zero\");\n"
+    "    if (b == -1)\n"
+    "        return (int64_t)(0 - (uint64_t)a);\n"
+    "    return a / b;\n"
+    "}\n"
+    "\n"
+    "static inline int64_t rt_index(int64_t row, int64_t col, uint32_t rows, uint32_t cols, int line,\n"
+    "                               const char *name) {\n"
+    "    if ((uint64_t)row >= rows || (cols ? (uint64_t)col >= cols : col != 0))\n"
+    "        rt_range(line, row < 0 || row >= rows ? row : col, name);\n"
+    "    return cols ? row * cols + col : row;\n"
+    "}\n"
+    "\n"
+    "static void *rt_grow_rows(RtRows *a, size_t size, uint32_t cols, int64_t row, int64_t col, int line,\n"
+    "                          const char *name) {\n"
+    "    uint32_t width = cols ? cols : 1, rows;\n"
+    "    void *data;\n"
+    "\n"
+    "    if (row < 0 || col < 0 || (cols && col >= cols) || row >= RT_MAX_ROWS)\n"
+    "        rt_range(line, row < 0 || row >= a->rows ? row : col, name);\n"
+    "    if (row >= a->rows) {\n"
+    "        rows = a->rows ? a->rows : 8;\n"
+    "        while (rows <= row)\n"
+    "            rows *= 2;\n"
+    "        if (rows > RT_MAX_ROWS)\n"
+    "            rows = RT_MAX_ROWS;\n"
+    "        data = calloc((size_t)rows * width, size);\n"
+    "        if (!data) {\n"
+    "            fprintf(stderr, \"Error: Out of memory\\n\");\n"
+    "            exit(1);\n"
+    "        }\n"
+    "        if (a->rows)\n"
+    "            memcpy(data, a->data, (size_t)a->rows * width * size);\n"
+    "        free(a->data);\n"
+    "        a->data = data;\n"
+    "        a->rows = rows;\n"
+    "    }\n"
+    "    return (char *)a->data + (size_t)(row * width + col) * size;\n"
+    "}\n"
+    "\n"
+    "static inline void *rt_grow(RtRows *a, size_t size, uint32_t cols, int64_t row, int64_t col, int line,\n"
+    "                            const char *name) {\n"
+    "    if ((uint64_t)row < a->rows && (cols ? (uint64_t)col < cols : col == 0))\n"
+    "        return (char *)a->data + (size_t)(cols ? row * cols + col : row) * size;\n"
+    "    return rt_grow_rows(a, size, cols, row, col, line, name);\n"
+    "}\n"
+    "\n"
+    "// Reads copy the element out at once, since a later index may grow the rows\n"
+    "static inline int64_t rt_get_i(RtRows *a, uint32_t cols, int64_t row, int64_t col, int line, const char *name) {\n"
+    "    return *(int64_t *)rt_grow(a, sizeof(int64_t), cols, row, col, line, name);\n"
+    "}\n"
+    "\n"
+    "static inline double rt_get_f(RtRows *a, uint32_t cols, int64_t row, int64_t col, int line, const char *name) {\n"
+    "    return *(double *)rt_grow(a, sizeof(double), cols, row, col, line, name);\n"
+    "}\n"
+    "\n"
+    "static inline RtRef rt_ref(void *fixed, RtRows *rows, uint32_t n, uint32_t cols, const char *name) {\n"
+    "    RtRef r;\n"
+    "\n"
+    "    r.fixed = fixed;\n"
+    "    r.rows = rows;\n"
+    "    r.n = n;\n"
+    "    r.cols = cols;\n"
+    "    r.name = name;\n"
+    "    return r;\n"
+    "}\n"
+    "\n"
+    "static inline void *rt_at(RtRef r, size_t size, int64_t row, int64_t col, int used, int line) {\n"
+    "    if (used != (r.cols ? 2 : 1))\n"
+    "        rt_error(line, \"'%s' has %d dimensions but is indexed with %d\", r.name, r.cols ? 2 : 1, used);\n"
+    "    if (!r.rows)\n"
+    "        return (char *)r.fixed + (size_t)rt_index(row, col, r.n, r.cols, line, r.name) * size;\n"
+    "    return rt_grow(r.rows, size, r.cols, row, col, line, r.name);\n"
+    "}\n"
+    "\n"
+    "static inline int64_t rt_at_i(RtRef r, int64_t row, int64_t col, int used, int line) {\n"
+    "    return *(int64_t *)rt_at(r, sizeof(int64_t), row, col, used, line);\n"
+    "}\n"
+    "\n"
+    "static inline double rt_at_f(RtRef r, int64_t row, int64_t col, int used, int line) {\n"
+    "    return *(double *)rt_at(r, sizeof(double), row, col, used, line);\n"
+    "}\n"
+    "\n"
+    "// At the end of the input, or on anything that is not a number, 0\n"
+    "static inline int64_t rt_read_int(void) {\n"
+    "    long long i;\n"
+    "\n"
+    "    if (scanf(\"%lld\", &i) != 1)\n"
+    "        i = 0;\n"
+    "    return i;\n"
+    "}\n"
+    "\n"
+    "static inline double rt_read_float(void) {\n"
+    "    double d;\n"
+    "\n"
+    "    if (scanf(\"%lf\", &d) != 1)\n"
+    "        d = 0;\n"
+    "    return d;\n"
+    "}\n"
+    "\n"
+    "static inline void rt_write_int(int64_t v) { printf(\"%lld\\n\", (long long)v); }\n"
+    "static inline void rt_write_float(double v) { printf(\"%g\\n\", v); }\n"
+    "\n";
+
+// What --run would run without an entry (see run_program in interp.c)
+static void write_entry(Gen *g, Text *out, const AstNode *program) {
+    const InternPool *pool = &g->in->ctx->symbol_table.strings;
+    uint32_t i;
+    NodeId id;
+
+    if (program->b) {
+        put(out, "    program();\n");
+        return;
+    }
+    for (i = 0; i < g->in->classes.count; i++) {
+        AST_FOREACH(AST, ast_at(AST, g->in->classes.classes[i].decl)->b, id) {
+            const AstNode *node = ast_at(AST, id);
+            if (node->kind == AST_METHOD && !node->a && intern_len(pool, node->v.sym) == 4 &&
+                memcmp(intern_str(pool, node->v.sym), "main", 4) == 0) {
+                put(out, "    ");
+                fn_name(g, out, instance(g, i, id, 0));
+                put(out, "(rt_new(sizeof(");
+                struct_name(g, out, i);
+                put(out, ")), %u);\n", node->line);
+                return;
+            }
+        }
+    }
+    for (i = 0; i < g->in->classes.count; i++) {
+        int first = 1;
+
+        AST_FOREACH(AST, ast_at(AST, g->in->classes.classes[i].decl)->b, id) {
+            if (ast_at(AST, id)->kind != AST_METHOD || ast_at(AST, id)->a)
+                continue;
+            if (first) {
+                put(out, "    {\n        ");
+                struct_name(g, out, i);
+                put(out, " *o = rt_new(sizeof(");
+                struct_name(g, out, i);
+                put(out, "));\n\n");
+                first = 0;
+            }
+            put(out, "        ");
+            fn_name(g, out, instance(g, i, id, 0));
+            put(out, "(o, %u);\n", ast_at(AST, id)->line);
+        }
+        if (!first)
+            put(out, "    }\n");
+    }
+}
+
+int cgen_program(ParseContext *ctx) {
+    const AstNode *program = ast_at(&ctx->ast, ctx->root);
+    Interp state;
+    Gen gen;
+    Gen *g = &gen;
+    Text out = {0}, main_text = {0}, top = {0}, bodies = {0};
+    uint32_t i;
+
+    interp_init(&state, ctx);
+    memset(g, 0, sizeof(*g));
+    g->in = &state;
+
+    write_entry(g, &main_text, program);
+    if (program->b) {
+        g->self = CLASS_NONE;
+        g->method = 0;
+        put(&top, "static void program(void) {\n");
+        function_body(g, &top, program->b, "");
+        put(&top, "}\n\n");
+    }
+    // Calls queue more instances as their callers are written
+    for (i = 0; i < g->ninstances; i++)
+        write_instance(g, &bodies, i);
+
+    put(&out, "%s", prelude);
+    for (i = 0; i < g->in->classes.count; i++) {
+        struct_name(g, &out, i);
+        put(&out, ";\n");
+    }
+    put(&out, "\n");
+    for (i = 0; i < g->in->classes.count; i++)
+        write_struct(g, &out, i);
+    // An object is made the first time its variable is used as one
+    for (i = 0; i < g->in->classes.count; i++) {
+        put(&out, "static inline ");
+        struct_name(g, &out, i);
+        put(&out, " *o%u_%.*s(", i, NAME(g->in->classes.classes[i].name));
+        struct_name(g, &out, i);
+        put(&out, " **p) {\n    if (!*p)\n        *p = rt_new(sizeof(**p));\n    return *p;\n}\n\n");
+    }
+    for (i = 0; i < g->ninstances; i++) {
+        signature(g, &out, i);
+        put(&out, ";\n");
+    }
+    put(&out, "\n%s%s", T(top), T(bodies));
+    put(&out, "int main(void) {\n    static char buf[1 << 16];\n\n    setvbuf(stdout, buf, _IOFBF, sizeof(buf));\n");
+    put(&out, "%s    return 0;\n}\n", T(main_text));
+
+    if (!g->errors)
+        fwrite(out.s, 1, out.len, ctx->out);
+    free(out.s);
+    free(main_text.s);
+    free(top.s);
+    free(bodies.s);
+    free(g->temps.s);
+    free(g->instances);
+    interp_free(&state);
+    return g->errors != 0;
+}
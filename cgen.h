@@ -0,0 +1,11 @@
+#ifndef CGEN_H
+#define CGEN_H
+
+#include "context.h"
+
+// Writes the program of a successful parse to ctx->out as one C file that
+// runs it the way --run does (see cgen.c). Returns 0, or 1 after reporting
+// what cannot be translated, in which case nothing is written.
+int cgen_program(ParseContext *ctx);
+
+#endif
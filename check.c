@@ -0,0 +1,593 @@
+#include "check.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hierarchy.h"
+#include "parser.tab.h"
+#include "pool.h"
+#include "scope.h"
+
+// Semantic checks over the tree of a finished parse. Names are declared
+// into a ScopeTable as the walk enters classes, methods and blocks:
+// classes at the top, fields and methods in their class, parameters and
+// the body's declarations in the method, and nested blocks on top of that.
+// Names a class inherits, and members reached through a class-typed
+// variable, come from the flattened member tables of the Hierarchy.
+//
+// Once the class names and the hierarchy are known, every class is
+// checked on its own, so the classes are split into ranges checked on the
+// worker pool. Each range collects its diagnostics in memory and the
+// ranges are printed in class order, so the report never depends on
+// scheduling.
+
+#define CHECK_TASKS_PER_WORKER 8
+#define CHECK_SPINE_INITIAL 64
+
+enum { TYPE_STRING = TYPE_CLASS + 1, TYPE_UNKNOWN };
+
+typedef struct {
+    uint8_t kind;           // TYPE_* of ast.h, TYPE_STRING or TYPE_UNKNOWN
+    uint8_t dims;           // array dimensions not indexed yet
+    SymbolId cls;           // for TYPE_CLASS
+    NodeId decl;            // declaration of an array, for its sizes
+} Type;
+
+typedef struct {
+    char *text;
+    size_t len;
+} Report;
+
+typedef struct {
+    ParseContext *ctx;
+    Hierarchy *classes;     // shared by all checkers
+    ScopeTable scopes;
+    uint32_t current;       // class whose methods are being checked, or CLASS_NONE
+    NodeId method;          // method being checked, or 0
+    NodeId *spine;          // operators above the current operand of a chain
+    uint32_t spine_len;
+    uint32_t spine_capacity;
+    FILE *err;              // opened on the first error
+    Report report;
+    int errors;
+} Checker;
+
+typedef struct {
+    ParseContext *ctx;
+    Hierarchy *classes;
+    uint32_t per_task;
+    Report *reports;        // the class names, then one per task
+} CheckRun;
+
+static const Type unknown = { TYPE_UNKNOWN, 0, 0, 0 };
+
+#define AST (&c->ctx->ast)
+#define NAME(sym) (int)intern_len(&c->ctx->symbol_table.strings, (sym)), \
+                  intern_str(&c->ctx->symbol_table.strings, (sym))
+
+static uint32_t list_length(const Ast *ast, NodeId list) {
+    uint32_t n = 0;
+    NodeId id;
+
+    AST_FOREACH(ast, list, id)
+        n++;
+    return n;
+}
+
+static void checker_init(Checker *c, ParseContext *ctx, Hierarchy *classes) {
+    memset(c, 0, sizeof(*c));
+    c->ctx = ctx;
+    c->classes = classes;
+    c->current = CLASS_NONE;
+}
+
+static void checker_finish(Checker *c, Report *report) {
+    if (c->err)
+        fclose(c->err);
+    *report = c->report;
+    scope_table_free(&c->scopes);
+    free(c->spine);
+}
+
+// Every checker stops at the limit; the merge applies it to the total
+static void semantic_error(Checker *c, uint32_t line, const char *fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+static void semantic_error(Checker *c, uint32_t line, const char *fmt, ...) {
+    int max = c->ctx->max_errors;
+    va_list ap;
+
+    if (max && c->errors >= max)
+        return;
+    if (!c->err && !(c->err = open_memstream(&c->report.text, &c->report.len)))
+        return;
+    c->errors++;
+    fprintf(c->err, "Semantic Error at line %u: ", line);
+    va_start(ap, fmt);
+    vfprintf(c->err, fmt, ap);
+    va_end(ap);
+    fputc('\n', c->err);
+}
+
+static void declare(Checker *c, NodeId decl, SymbolKind kind) {
+    const AstNode *node = ast_at(AST, decl);
+    const Symbol *earlier = scope_declare(&c->scopes, node->v.sym, kind, decl);
+
+    if (earlier)
+        semantic_error(c, node->line, "'%.*s' is already declared at line %u",
+                       NAME(node->v.sym), ast_at(AST, earlier->decl)->line);
+}
+
+// Declaration of a name used in a method body: a local, parameter or
+// member of the class, or a member the class inherits
+static NodeId lookup(Checker *c, SymbolId name) {
+    const Symbol *sym = scope_lookup(&c->scopes, name);
+
+    if (sym)
+        return sym->decl;
+    if (c->current != CLASS_NONE)
+        return hierarchy_member(c->classes, c->current, name);
+    return 0;
+}
+
+static Type type_of_node(NodeId type_node, const Ast *ast) {
+    const AstNode *node = ast_at(ast, type_node);
+    Type t = unknown;
+
+    if (type_node && node->kind == AST_TYPE) {
+        t.kind = (uint8_t)node->op;
+        t.cls = node->op == TYPE_CLASS ? node->v.sym : 0;
+    }
+    return t;
+}
+
+static Type type_of_decl(Checker *c, NodeId decl) {
+    const AstNode *node = ast_at(AST, decl);
+    Type t;
+
+    switch (node->kind) {
+    case AST_FIELD:
+        t = type_of_node(node->a, AST);
+        t.dims = (uint8_t)((node->b != 0) + (node->c != 0));
+        break;
+    case AST_PARAM:
+        t = type_of_node(node->a, AST);
+        t.dims = (node->flags & AST_ARRAY) ? 1 : 0;
+        break;
+    case AST_DECL:
+        t = type_of_node(node->a, AST);
+        break;
+    default:
+        return unknown;
+    }
+    t.decl = decl;
+    return t;
+}
+
+static const char *type_name(const Type *t) {
+    switch (t->kind) {
+    case TYPE_INTEGER: return "integer";
+    case TYPE_FLOAT: return "float";
+    case TYPE_VOID: return "void";
+    case TYPE_STRING: return "string";
+    default: return "object";
+    }
+}
+
+static int is_number(const Type *t) {
+    return t->dims == 0 && (t->kind == TYPE_INTEGER || t->kind == TYPE_FLOAT);
+}
+
+static void check_type(Checker *c, NodeId type_node) {
+    const AstNode *node = ast_at(AST, type_node);
+
+    if (type_node && node->kind == AST_TYPE && node->op == TYPE_CLASS &&
+        hierarchy_find(c->classes, node->v.sym) == CLASS_NONE)
+        semantic_error(c, node->line, "class '%.*s' is not declared", NAME(node->v.sym));
+}
+
+// Only narrowing a float into an integer is refused; integers widen
+static void check_assign(Checker *c, uint32_t line, SymbolId target, const Type *to, const Type *value) {
+    if (is_number(to) && is_number(value) && to->kind == TYPE_INTEGER && value->kind == TYPE_FLOAT)
+        semantic_error(c, line, "cannot assign a float to integer '%.*s'", NAME(target));
+}
+
+static Type check_expr(Checker *c, NodeId expr);
+
+static Type check_name(Checker *c, const AstNode *node) {
+    NodeId decl = lookup(c, node->v.sym);
+
+    if (!decl) {
+        semantic_error(c, node->line, "'%.*s' is not declared", NAME(node->v.sym));
+        return unknown;
+    }
+    return type_of_decl(c, decl);
+}
+
+// Declaration of the member node names in class cls, or 0; a missing
+// member is reported
+static NodeId check_member(Checker *c, const AstNode *node, uint32_t cls) {
+    NodeId decl;
+
+    if (cls == CLASS_NONE)
+        return 0;
+    decl = hierarchy_member(c->classes, cls, node->v.sym);
+    if (!decl)
+        semantic_error(c, node->line, "class '%.*s' has no member '%.*s'",
+                       NAME(c->classes->classes[cls].name), NAME(node->v.sym));
+    return decl;
+}
+
+// Class of the object named by node, or CLASS_NONE after reporting why
+// it has none. A class type that is not declared was reported already.
+static uint32_t check_receiver(Checker *c, const AstNode *node) {
+    Type t = check_name(c, node);
+
+    if (t.kind == TYPE_UNKNOWN)
+        return CLASS_NONE;
+    if (t.kind != TYPE_CLASS || t.dims) {
+        semantic_error(c, node->line, "'%.*s' is not an object", NAME(node->v.sym));
+        return CLASS_NONE;
+    }
+    return hierarchy_find(c->classes, t.cls);
+}
+
+static Type check_index(Checker *c, const AstNode *node) {
+    const AstNode *array = ast_at(AST, node->a);
+    NodeId index[2] = { node->b, node->c };
+    Type t = check_name(c, array);
+    int used = (node->b != 0) + (node->c != 0);
+    int i;
+
+    for (i = 0; i < used; i++) {
+        Type it = check_expr(c, index[i]);
+        if (is_number(&it) && it.kind != TYPE_INTEGER)
+            semantic_error(c, node->line, "index of '%.*s' is not an integer", NAME(array->v.sym));
+    }
+    if (t.kind == TYPE_UNKNOWN)
+        return unknown;
+    if (t.dims != used) {
+        if (t.dims == 0)
+            semantic_error(c, node->line, "'%.*s' is not an array", NAME(array->v.sym));
+        else
+            semantic_error(c, node->line, "'%.*s' has %d dimensions but is indexed with %d",
+                           NAME(array->v.sym), t.dims, used);
+        return unknown;
+    }
+    // Fields declare their sizes, so constant indexes can be checked
+    if (ast_at(AST, t.decl)->kind == AST_FIELD) {
+        const AstNode *decl = ast_at(AST, t.decl);
+        NodeId size[2] = { decl->b, decl->c };
+
+        for (i = 0; i < used; i++) {
+            const AstNode *idx = ast_at(AST, index[i]);
+            const AstNode *sz = ast_at(AST, size[i]);
+            if (idx->kind == AST_INT && sz->kind == AST_INT && (idx->v.ival < 0 || idx->v.ival >= sz->v.ival))
+                semantic_error(c, idx->line, "index %lld is out of range for '%.*s' of size %lld",
+                               (long long)idx->v.ival, NAME(array->v.sym), (long long)sz->v.ival);
+        }
+    }
+    t.dims = 0;
+    return t;
+}
+
+static Type check_call(Checker *c, const AstNode *node) {
+    NodeId decl = 0;
+    NodeId id;
+
+    if (node->op == CALL_FUNCTION) {
+        decl = lookup(c, node->v.sym);
+        if (!decl)
+            semantic_error(c, node->line, "'%.*s' is not declared", NAME(node->v.sym));
+    } else if (node->op == CALL_METHOD) {
+        decl = check_member(c, node, check_receiver(c, ast_at(AST, node->a)));
+    } else {
+        const AstNode *cls = ast_at(AST, node->a);
+        uint32_t index = hierarchy_find(c->classes, cls->v.sym);
+        if (index == CLASS_NONE)
+            semantic_error(c, cls->line, "class '%.*s' is not declared", NAME(cls->v.sym));
+        decl = check_member(c, node, index);
+    }
+    AST_FOREACH(AST, node->b, id)
+        check_expr(c, id);
+    if (!decl)
+        return unknown;
+    if (ast_at(AST, decl)->kind != AST_METHOD) {
+        semantic_error(c, node->line, "'%.*s' is not a method", NAME(node->v.sym));
+        return unknown;
+    }
+    return type_of_node(ast_at(AST, decl)->b, AST);
+}
+
+static Type binary_type(int op, const Type *left, const Type *right) {
+    Type t = unknown;
+
+    switch (op) {
+    case PLUS: case MINUS: case MULT: case DIV:
+        if (is_number(left) && is_number(right))
+            t.kind = left->kind == TYPE_FLOAT || right->kind == TYPE_FLOAT ? TYPE_FLOAT : TYPE_INTEGER;
+        return t;
+    default:
+        t.kind = TYPE_INTEGER;  // comparisons and logic yield a truth value
+        return t;
+    }
+}
+
+// Operator chains nest to the left, so the left spine is walked with an
+// explicit stack rather than by recursion
+static Type check_chain(Checker *c, NodeId expr) {
+    uint32_t base = c->spine_len;
+    Type t;
+
+    for (; ast_at(AST, expr)->kind == AST_BINARY; expr = ast_at(AST, expr)->a) {
+        if (c->spine_len == c->spine_capacity) {
+            c->spine_capacity = c->spine_capacity ? c->spine_capacity * 2 : CHECK_SPINE_INITIAL;
+            c->spine = realloc(c->spine, c->spine_capacity * sizeof(NodeId));
+            if (!c->spine) {
+                fprintf(stderr, "Error: Out of memory\n");
+                exit(1);
+            }
+        }
+        c->spine[c->spine_len++] = expr;
+    }
+    t = check_expr(c, expr);
+    while (c->spine_len > base) {
+        const AstNode *op = ast_at(AST, c->spine[--c->spine_len]);
+        Type right = check_expr(c, op->b);
+        t = binary_type(op->op, &t, &right);
+    }
+    return t;
+}
+
+static Type check_expr(Checker *c, NodeId expr) {
+    const AstNode *node = ast_at(AST, expr);
+    Type t = unknown;
+
+    switch (node->kind) {
+    case AST_BINARY:
+        return check_chain(c, expr);
+    case AST_NOT:
+        check_expr(c, node->a);
+        t.kind = TYPE_INTEGER;
+        return t;
+    case AST_INT:
+        t.kind = TYPE_INTEGER;
+        return t;
+    case AST_FLOAT:
+        t.kind = TYPE_FLOAT;
+        return t;
+    case AST_STRING:
+        t.kind = TYPE_STRING;
+        return t;
+    case AST_NAME:
+        return check_name(c, node);
+    case AST_INDEX:
+        return check_index(c, node);
+    case AST_MEMBER: {
+        NodeId decl = check_member(c, node, check_receiver(c, ast_at(AST, node->a)));
+        return decl ? type_of_decl(c, decl) : unknown;
+    }
+    case AST_CALL:
+        return check_call(c, node);
+    default:
+        return unknown;
+    }
+}
+
+// Name that an assignment target stores into, for messages
+static SymbolId target_name(Checker *c, NodeId target) {
+    const AstNode *node = ast_at(AST, target);
+
+    return node->kind == AST_INDEX ? ast_at(AST, node->a)->v.sym : node->v.sym;
+}
+
+static void check_return(Checker *c, const AstNode *node) {
+    const AstNode *method = c->method ? ast_at(AST, c->method) : NULL;
+    Type declared, value;
+
+    if (!method || !method->b) {
+        check_expr(c, node->a);     // outside a method, or no declared type
+        return;
+    }
+    declared = type_of_node(method->b, AST);
+    if (!node->a) {
+        if (declared.kind != TYPE_VOID)
+            semantic_error(c, node->line, "method '%.*s' must return %s",
+                           NAME(method->v.sym), type_name(&declared));
+        return;
+    }
+    value = check_expr(c, node->a);
+    if (declared.kind == TYPE_VOID)
+        semantic_error(c, node->line, "void method '%.*s' returns a value", NAME(method->v.sym));
+    else if (is_number(&declared) && is_number(&value) && declared.kind == TYPE_INTEGER &&
+             value.kind == TYPE_FLOAT)
+        semantic_error(c, node->line, "method '%.*s' returns a float but is declared integer",
+                       NAME(method->v.sym));
+}
+
+static void check_stmt(Checker *c, NodeId stmt) {
+    const AstNode *node = ast_at(AST, stmt);
+    Type to, value;
+    NodeId id;
+
+    switch (node->kind) {
+    case AST_DECL:
+        check_type(c, node->a);
+        if (node->b) {
+            to = type_of_node(node->a, AST);
+            value = check_expr(c, node->b);
+            check_assign(c, node->line, node->v.sym, &to, &value);
+        }
+        declare(c, stmt, SYM_LOCAL);
+        break;
+    case AST_BLOCK:
+        scope_push(&c->scopes, list_length(AST, node->a));
+        AST_FOREACH(AST, node->a, id)
+            check_stmt(c, id);
+        scope_pop(&c->scopes);
+        break;
+    case AST_ASSIGN:
+        to = check_expr(c, node->a);
+        value = check_expr(c, node->b);
+        check_assign(c, node->line, target_name(c, node->a), &to, &value);
+        break;
+    case AST_IF:
+        check_expr(c, node->a);
+        check_stmt(c, node->b);
+        if (node->c)
+            check_stmt(c, node->c);
+        break;
+    case AST_WHILE:
+        check_expr(c, node->a);
+        check_stmt(c, node->b);
+        break;
+    case AST_READ:
+    case AST_WRITE:
+        check_expr(c, node->a);
+        break;
+    case AST_RETURN:
+        check_return(c, node);
+        break;
+    default:
+        break;
+    }
+}
+
+static void check_method(Checker *c, NodeId method) {
+    const AstNode *node = ast_at(AST, method);
+    NodeId id;
+
+    check_type(c, node->b);
+    scope_push(&c->scopes, list_length(AST, node->a) + list_length(AST, node->c));
+    AST_FOREACH(AST, node->a, id) {
+        check_type(c, ast_at(AST, id)->a);
+        declare(c, id, SYM_PARAM);
+    }
+    c->method = method;
+    AST_FOREACH(AST, node->c, id)
+        check_stmt(c, id);
+    c->method = 0;
+    scope_pop(&c->scopes);
+}
+
+static void check_bases(Checker *c, uint32_t cls) {
+    const ClassInfo *info = &c->classes->classes[cls];
+    const AstNode *node = ast_at(AST, info->decl);
+    NodeId id;
+
+    AST_FOREACH(AST, node->a, id) {
+        const AstNode *base = ast_at(AST, id);
+        if (hierarchy_find(c->classes, base->v.sym) == CLASS_NONE)
+            semantic_error(c, base->line, "unknown base class '%.*s'", NAME(base->v.sym));
+    }
+    if (info->cycle_base != CLASS_NONE)
+        semantic_error(c, node->line, "class '%.*s' inherits from itself through '%.*s'",
+                       NAME(info->name), NAME(c->classes->classes[info->cycle_base].name));
+    if (info->inconsistent)
+        semantic_error(c, node->line, "cannot order the bases of class '%.*s'", NAME(info->name));
+}
+
+static void check_class(Checker *c, uint32_t cls) {
+    const AstNode *node = ast_at(AST, c->classes->classes[cls].decl);
+    NodeId id;
+
+    check_bases(c, cls);
+    // All members first, so a method body sees every field and method
+    scope_push(&c->scopes, list_length(AST, node->b));
+    AST_FOREACH(AST, node->b, id) {
+        const AstNode *member = ast_at(AST, id);
+        if (member->kind == AST_FIELD) {
+            check_type(c, member->a);
+            declare(c, id, SYM_FIELD);
+        } else if (member->kind == AST_METHOD) {
+            declare(c, id, SYM_METHOD);
+        }
+    }
+    c->current = cls;
+    AST_FOREACH(AST, node->b, id) {
+        if (ast_at(AST, id)->kind == AST_METHOD)
+            check_method(c, id);
+    }
+    c->current = CLASS_NONE;
+    scope_pop(&c->scopes);
+}
+
+// Pool task: check one range of classes with a checker of its own
+static void check_range(void *arg, size_t task) {
+    CheckRun *run = arg;
+    Checker checker;
+    uint32_t first = (uint32_t)task * run->per_task;
+    uint32_t last = first + run->per_task;
+    uint32_t i;
+
+    if (last > run->classes->count)
+        last = run->classes->count;
+    checker_init(&checker, run->ctx, run->classes);
+    for (i = first; i < last; i++)
+        check_class(&checker, i);
+    checker_finish(&checker, &run->reports[task + 1]);
+}
+
+// Prints the reports in order, up to ctx->max_errors lines in all
+static int merge_reports(ParseContext *ctx, Report *reports, size_t count) {
+    int max = ctx->max_errors;
+    int errors = 0;
+    size_t i;
+
+    for (i = 0; i < count; i++) {
+        const char *p = reports[i].text;
+        const char *end = p + reports[i].len;
+
+        while (p < end && !(max && errors >= max)) {
+            const char *nl = memchr(p, '\n', (size_t)(end - p));
+            size_t len = nl ? (size_t)(nl - p) + 1 : (size_t)(end - p);
+            fwrite(p, 1, len, ctx->err);
+            p += len;
+            if (++errors == max)
+                fprintf(ctx->err, "Too many errors, giving up\n");
+        }
+        free(reports[i].text);
+    }
+    return errors;
+}
+
+// Reports semantic errors to ctx->err, up to ctx->max_errors of them, using
+// up to ctx->workers threads. Returns the number of errors.
+int check_program(ParseContext *ctx) {
+    const AstNode *program = ast_at(&ctx->ast, ctx->root);
+    Hierarchy classes;
+    Checker top;
+    CheckRun run = { ctx, &classes, 1, NULL };
+    Checker *c = &top;
+    size_t ntasks = 0;
+    int workers = ctx->workers > 0 ? ctx->workers : 1;
+    int errors;
+    NodeId id;
+
+    hierarchy_build(&classes, &ctx->ast, program->a);
+    checker_init(c, ctx, &classes);
+    if (program->a) {
+        scope_push(&c->scopes, list_length(AST, program->a));
+        AST_FOREACH(AST, program->a, id) {
+            if (ast_at(AST, id)->kind == AST_CLASS)
+                declare(c, id, SYM_CLASS);
+        }
+        run.per_task = classes.count / ((uint32_t)workers * CHECK_TASKS_PER_WORKER) + 1;
+        ntasks = (classes.count + run.per_task - 1) / run.per_task;
+    } else {
+        scope_push(&c->scopes, list_length(AST, program->b));
+        AST_FOREACH(AST, program->b, id)
+            check_stmt(c, id);
+    }
+    run.reports = calloc(ntasks + 1, sizeof(Report));
+    if (!run.reports) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    checker_finish(c, &run.reports[0]);
+    pool_run(workers, ntasks, check_range, &run);
+    errors = merge_reports(ctx, run.reports, ntasks + 1);
+    free(run.reports);
+    hierarchy_free(&classes);
+    return errors;
+}
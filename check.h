@@ -0,0 +1,8 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+#include "context.h"
+
+int check_program(ParseContext *ctx);
+
+#endif
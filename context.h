@@ -0,0 +1,88 @@
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include <stdio.h>
+#include "ast.h"
+#include "emit.h"
+#include "lines.h"
+#include "source.h"
+#include "stats.h"
+#include "tokens.h"
+
+// Input of a context that lexes one chunk of a larger file (see parlex.c)
+typedef struct {
+    const char *source;     // start of the whole mapped file; lexemes point here
+    const char *next;       // YY_INPUT copies from here up to end
+    const char *end;
+    uint64_t *unknown;      // offsets of unknown characters, reported at replay
+    size_t unknown_count;
+    size_t unknown_capacity;
+} ChunkInput;
+
+// Input a caller pushes in pieces (see parse_push). Only bytes the scanner
+// has not finished with are kept.
+typedef struct {
+    char *buf;              // holds input from file offset base
+    size_t len;
+    size_t capacity;
+    uint64_t base;
+    size_t pos;             // YY_INPUT copies from buf + pos up to buf + len
+    int closed;             // the caller has pushed the end of the input
+    int starved;            // YY_INPUT ran out before the end of the input
+    size_t wait;            // bytes past pos needed before scanning again
+    int result;             // PUSH_MORE until the parser finishes
+    void *parser;           // yypstate
+} PushInput;
+
+#define PUSH_MORE (-1)
+
+struct ParallelLex;
+struct ParseContext;
+
+// Called as each top-level class is parsed, before a streaming parse drops it
+typedef void (*ClassFn)(struct ParseContext *ctx, NodeId cls, void *arg);
+
+// Everything one parse needs. Scanner and parser keep no globals, so each
+// thread can work on its own context.
+typedef struct ParseContext {
+    const char *path;
+    uint64_t offset;        // bytes consumed by the scanner so far
+    LineIndex lines;
+    size_t line_hint;       // for line lookups in token order
+    TokenStore symbol_table;
+    SymbolId token;         // lexeme of the most recent token, handed to the parser
+    uint64_t token_offset;
+    Ast ast;
+    NodeId root;
+    void *scanner;          // yyscan_t
+    FILE *input_file;
+    SourceMap map;
+    FILE *out;              // report and diagnostics for this file
+    FILE *err;
+    Emitter *stream;        // if set, token rows are written here as they are lexed
+    ChunkInput *chunk;      // set for chunk scanners
+    struct ParallelLex *replay; // set when the file was lexed in parallel
+    PushInput *push;        // set when the caller pushes the input
+    ClassFn on_class;
+    void *on_class_arg;
+    int errors;             // syntax errors reported so far
+    int max_errors;         // give up after this many; 0 means no limit
+    Stats *stats;           // set for --stats
+    int check;              // run the semantic checks after the parse
+    int workers;            // threads the checks may use
+    const char *run;        // entry for --run ("" picks one), or NULL
+    int engine;             // ENGINE_* of interp.h that --run uses
+    int translate;          // --emit=c: write the program as C instead of a report
+    int fold;               // fold constant expressions before --run or --emit=c
+} ParseContext;
+
+int context_open(ParseContext *ctx, const char *path, int use_mmap);
+int context_open_chunk(ParseContext *ctx, ChunkInput *in, uint64_t offset);
+int context_open_push(ParseContext *ctx, const char *name);
+int push_input(ParseContext *ctx, const char *buf, size_t len);
+int parse_push(ParseContext *ctx, const char *buf, size_t len);
+void context_close(ParseContext *ctx);
+void print_symbol_table(ParseContext *ctx);
+void report_unknown_char(ParseContext *ctx, uint64_t offset, char c);
+
+#endif
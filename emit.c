@@ -0,0 +1,257 @@
+#include "emit.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define CELL_WIDTH 13
+#define ROW_SLACK 64    // everything in a row except the two names
+
+#define EMIT_LITERAL(e, s) emit_bytes(e, s, sizeof(s) - 1)
+
+static const char table_rule[] = "+---------------+---------------+---------------+\n";
+
+void emitter_init(Emitter *e, FILE *out) {
+    e->out = out;
+    e->len = 0;
+    e->buf = malloc(EMIT_BUFFER_SIZE);
+    if (!e->buf) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+}
+
+void emitter_flush(Emitter *e) {
+    if (e->len) {
+        fwrite(e->buf, 1, e->len, e->out);
+        e->len = 0;
+    }
+}
+
+void emitter_free(Emitter *e) {
+    emitter_flush(e);
+    free(e->buf);
+    e->buf = NULL;
+}
+
+void emit_bytes(Emitter *e, const char *s, size_t len) {
+    if (e->len + len > EMIT_BUFFER_SIZE) {
+        emitter_flush(e);
+        if (len > EMIT_BUFFER_SIZE) {
+            fwrite(s, 1, len, e->out);
+            return;
+        }
+    }
+    memcpy(e->buf + e->len, s, len);
+    e->len += len;
+}
+
+// LEB128: seven bits per byte, high bit set on all but the last
+void emit_varint(Emitter *e, uint64_t value) {
+    if (e->len + 10 > EMIT_BUFFER_SIZE)
+        emitter_flush(e);
+    while (value >= 0x80) {
+        e->buf[e->len++] = (char)(value | 0x80);
+        value >>= 7;
+    }
+    e->buf[e->len++] = (char)value;
+}
+
+// "text" left-aligned in a cell, like printf's %-13s
+static char *put_cell(char *p, const char *s, size_t len) {
+    memcpy(p, s, len);
+    p += len;
+    if (len < CELL_WIDTH) {
+        memset(p, ' ', CELL_WIDTH - len);
+        p += CELL_WIDTH - len;
+    }
+    return p;
+}
+
+static char *put_int(char *p, int value) {
+    char digits[12];
+    unsigned v = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+    int n = 0;
+
+    if (value < 0)
+        *p++ = '-';
+    do {
+        digits[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    while (n)
+        *p++ = digits[--n];
+    return p;
+}
+
+void emit_table_header(Emitter *e) {
+    EMIT_LITERAL(e, "\n");
+    EMIT_LITERAL(e, table_rule);
+    EMIT_LITERAL(e, "| Lexeme        | Token Type    | Location      |\n");
+    EMIT_LITERAL(e, table_rule);
+}
+
+void emit_table_row(Emitter *e, const char *lexeme, size_t len, const char *type,
+                    int line_no, int column_no) {
+    size_t type_len = strlen(type);
+    char location[32];
+    char *loc = location;
+    char *p;
+
+    *loc++ = '(';
+    loc = put_int(loc, line_no);
+    *loc++ = ',';
+    *loc++ = ' ';
+    loc = put_int(loc, column_no);
+    *loc++ = ')';
+
+    if (e->len + len + type_len + ROW_SLACK > EMIT_BUFFER_SIZE) {
+        emitter_flush(e);
+        if (len + type_len + ROW_SLACK > EMIT_BUFFER_SIZE) {
+            // A lexeme larger than the whole buffer goes out on its own
+            fputs("| ", e->out);
+            fwrite(lexeme, 1, len, e->out);
+            lexeme = NULL;
+        }
+    }
+    p = e->buf + e->len;
+    if (lexeme) {
+        *p++ = '|';
+        *p++ = ' ';
+        p = put_cell(p, lexeme, len);
+    }
+    memcpy(p, " | ", 3);
+    p = put_cell(p + 3, type, type_len);
+    memcpy(p, " | ", 3);
+    p = put_cell(p + 3, location, (size_t)(loc - location));
+    memcpy(p, " |\n", 3);
+    e->len = (size_t)(p + 3 - e->buf);
+}
+
+void emit_table_footer(Emitter *e) {
+    EMIT_LITERAL(e, table_rule);
+}
+
+// Binary token stream, all integers varints:
+//
+//   "TOKB" version(2) path_len path parsed
+//   string_count { len bytes }...      every lexeme and type name, by id
+//   token_count { kind lexeme offset_delta line_delta column }...
+//
+// kind and lexeme are string table ids (kind names the token type), and
+// offset_delta and line_delta are the byte offset and line relative to
+// the previous token. Version 1 had no offsets.
+void emit_tokens_bin(Emitter *e, const TokenStore *ts, const LineIndex *lines,
+                     const char *path, int parsed) {
+    const InternPool *strings = &ts->strings;
+    const TokenChunk *chunk;
+    size_t path_len = strlen(path);
+    size_t hint = 0;
+    uint32_t id;
+    uint64_t prev_offset = 0;
+    int prev_line = 1;
+    int line, column;
+    int i;
+
+    EMIT_LITERAL(e, TOKENS_BIN_MAGIC);
+    emit_varint(e, path_len);
+    emit_bytes(e, path, path_len);
+    emit_varint(e, parsed != 0);
+    emit_varint(e, strings->count);
+    for (id = 0; id < strings->count; id++) {
+        emit_varint(e, intern_len(strings, id));
+        emit_bytes(e, intern_str(strings, id), intern_len(strings, id));
+    }
+    emit_varint(e, ts->count);
+    for (chunk = ts->head; chunk; chunk = chunk->next) {
+        for (i = 0; i < chunk->count; i++) {
+            const Token *tok = &chunk->tokens[i];
+            uint64_t offset = token_offset(chunk, tok);
+            line_index_find(lines, &hint, offset, &line, &column);
+            emit_varint(e, tok->token_type);
+            emit_varint(e, tok->lexeme);
+            emit_varint(e, offset - prev_offset);
+            emit_varint(e, (uint64_t)(line - prev_line));
+            emit_varint(e, (uint64_t)column);
+            prev_offset = offset;
+            prev_line = line;
+        }
+    }
+}
+
+static void emit_json_string(Emitter *e, const char *s, size_t len) {
+    static const char hex[] = "0123456789abcdef";
+    size_t start = 0;
+    size_t i;
+
+    EMIT_LITERAL(e, "\"");
+    for (i = 0; i < len; i++) {
+        unsigned char c = (unsigned char)s[i];
+        char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 15] };
+
+        if (c >= 0x20 && c != '"' && c != '\\')
+            continue;
+        emit_bytes(e, s + start, i - start);
+        if (c == '"' || c == '\\') {
+            esc[1] = (char)c;
+            emit_bytes(e, esc, 2);
+        } else {
+            emit_bytes(e, esc, 6);
+        }
+        start = i + 1;
+    }
+    emit_bytes(e, s + start, len - start);
+    EMIT_LITERAL(e, "\"");
+}
+
+static void emit_json_int(Emitter *e, int value) {
+    char buf[12];
+    emit_bytes(e, buf, (size_t)(put_int(buf, value) - buf));
+}
+
+// A header object with the file name, outcome and token count, then one
+// object per token
+void emit_ndjson_header(Emitter *e, const char *path, int parsed, size_t count) {
+    char digits[24];
+
+    EMIT_LITERAL(e, "{\"file\":");
+    emit_json_string(e, path, strlen(path));
+    if (parsed)
+        EMIT_LITERAL(e, ",\"parsed\":true");
+    else
+        EMIT_LITERAL(e, ",\"parsed\":false");
+    EMIT_LITERAL(e, ",\"tokens\":");
+    emit_bytes(e, digits, (size_t)snprintf(digits, sizeof(digits), "%zu", count));
+    EMIT_LITERAL(e, "}\n");
+}
+
+void emit_ndjson_row(Emitter *e, const char *lexeme, size_t len, const char *type, size_t type_len,
+                     int line_no, int column_no) {
+    EMIT_LITERAL(e, "{\"lexeme\":");
+    emit_json_string(e, lexeme, len);
+    EMIT_LITERAL(e, ",\"type\":");
+    emit_json_string(e, type, type_len);
+    EMIT_LITERAL(e, ",\"line\":");
+    emit_json_int(e, line_no);
+    EMIT_LITERAL(e, ",\"column\":");
+    emit_json_int(e, column_no);
+    EMIT_LITERAL(e, "}\n");
+}
+
+void emit_tokens_ndjson(Emitter *e, const TokenStore *ts, const LineIndex *lines,
+                        const char *path, int parsed) {
+    const InternPool *strings = &ts->strings;
+    const TokenChunk *chunk;
+    size_t hint = 0;
+    int line, column;
+    int i;
+
+    emit_ndjson_header(e, path, parsed, ts->count);
+    for (chunk = ts->head; chunk; chunk = chunk->next) {
+        for (i = 0; i < chunk->count; i++) {
+            const Token *tok = &chunk->tokens[i];
+            line_index_find(lines, &hint, token_offset(chunk, tok), &line, &column);
+            emit_ndjson_row(e, intern_str(strings, tok->lexeme), intern_len(strings, tok->lexeme),
+                            intern_str(strings, tok->token_type), intern_len(strings, tok->token_type),
+                            line, column);
+        }
+    }
+}
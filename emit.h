@@ -0,0 +1,48 @@
+#ifndef EMIT_H
+#define EMIT_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "lines.h"
+#include "tokens.h"
+
+#define EMIT_BUFFER_SIZE (1 << 20)
+#define TOKENS_BIN_MAGIC "TOKB\2"  // magic and format version of tokens-bin, 5 bytes
+
+typedef enum {
+    EMIT_TABLE,         // fixed-width ASCII report
+    EMIT_TOKENS_BIN,    // compact binary token stream, see emit_tokens_bin
+    EMIT_TOKENS_NDJSON, // one JSON object per line
+    EMIT_C              // the program as C, see cgen.c
+} EmitFormat;
+
+// Output buffer for token reports. Rows are formatted straight into one
+// large reusable buffer, which is written out whenever it fills up.
+typedef struct Emitter {
+    FILE *out;
+    char *buf;
+    size_t len;
+} Emitter;
+
+void emitter_init(Emitter *e, FILE *out);
+void emitter_flush(Emitter *e);
+void emitter_free(Emitter *e);
+
+void emit_bytes(Emitter *e, const char *s, size_t len);
+void emit_varint(Emitter *e, uint64_t value);
+
+void emit_table_header(Emitter *e);
+void emit_table_row(Emitter *e, const char *lexeme, size_t len, const char *type,
+                    int line_no, int column_no);
+void emit_table_footer(Emitter *e);
+
+void emit_tokens_bin(Emitter *e, const TokenStore *ts, const LineIndex *lines,
+                     const char *path, int parsed);
+void emit_tokens_ndjson(Emitter *e, const TokenStore *ts, const LineIndex *lines,
+                        const char *path, int parsed);
+void emit_ndjson_header(Emitter *e, const char *path, int parsed, size_t count);
+void emit_ndjson_row(Emitter *e, const char *lexeme, size_t len, const char *type, size_t type_len,
+                     int line_no, int column_no);
+
+#endif
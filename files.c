@@ -0,0 +1,116 @@
+#include "files.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#define MAX_RESPONSE_DEPTH 16
+
+static void path_list_add(PathList *list, const char *path) {
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? list->capacity * 2 : 64;
+        list->paths = realloc(list->paths, list->capacity * sizeof(char *));
+        if (!list->paths) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+    }
+    list->paths[list->count++] = strdup(path);
+}
+
+static int visible_entry(const struct dirent *entry) {
+    return entry->d_name[0] != '.';
+}
+
+static int collect_dir(PathList *list, const char *dir) {
+    struct dirent **entries;
+    int n, i;
+    int status = 0;
+
+    n = scandir(dir, &entries, visible_entry, alphasort);
+    if (n < 0) {
+        fprintf(stderr, "Error: Cannot open directory '%s'\n", dir);
+        return -1;
+    }
+    for (i = 0; i < n; i++) {
+        size_t len = strlen(dir) + strlen(entries[i]->d_name) + 2;
+        char *path = malloc(len);
+        struct stat st;
+
+        snprintf(path, len, "%s/%s", dir, entries[i]->d_name);
+        // A link to a file is followed, but not a link to a directory, so a
+        // link back up the tree cannot make the walk recurse forever
+        if (lstat(path, &st) == 0) {
+            if (S_ISDIR(st.st_mode)) {
+                if (collect_dir(list, path) != 0)
+                    status = -1;
+            } else if (S_ISREG(st.st_mode) ||
+                       (S_ISLNK(st.st_mode) && stat(path, &st) == 0 && S_ISREG(st.st_mode))) {
+                path_list_add(list, path);
+            }
+        }
+        free(path);
+        free(entries[i]);
+    }
+    free(entries);
+    return status;
+}
+
+static int collect(PathList *list, const char *arg, int depth);
+
+static int collect_response_file(PathList *list, const char *name, int depth) {
+    FILE *f;
+    char *line = NULL;
+    size_t cap = 0;
+    ssize_t len;
+    int status = 0;
+
+    if (depth > MAX_RESPONSE_DEPTH) {
+        fprintf(stderr, "Error: Response files nested too deeply at '%s'\n", name);
+        return -1;
+    }
+    f = fopen(name, "r");
+    if (!f) {
+        fprintf(stderr, "Error: Cannot open file '%s'\n", name);
+        return -1;
+    }
+    while ((len = getline(&line, &cap, f)) >= 0) {
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r' ||
+                           line[len - 1] == ' ' || line[len - 1] == '\t'))
+            line[--len] = '\0';
+        if (len == 0)
+            continue;
+        if (collect(list, line, depth + 1) != 0)
+            status = -1;
+    }
+    free(line);
+    fclose(f);
+    return status;
+}
+
+static int collect(PathList *list, const char *arg, int depth) {
+    struct stat st;
+
+    if (arg[0] == '@')
+        return collect_response_file(list, arg + 1, depth);
+    if (stat(arg, &st) == 0 && S_ISDIR(st.st_mode))
+        return collect_dir(list, arg);
+    // Missing files are kept so they are reported in input order
+    path_list_add(list, arg);
+    return 0;
+}
+
+int collect_inputs(PathList *list, const char *arg) {
+    return collect(list, arg, 0);
+}
+
+void path_list_free(PathList *list) {
+    size_t i;
+
+    for (i = 0; i < list->count; i++)
+        free(list->paths[i]);
+    free(list->paths);
+    list->paths = NULL;
+    list->count = list->capacity = 0;
+}
@@ -0,0 +1,19 @@
+#ifndef FILES_H
+#define FILES_H
+
+#include <stddef.h>
+
+typedef struct {
+    char **paths;
+    size_t count;
+    size_t capacity;
+} PathList;
+
+// Expand one command-line argument into input files: a directory adds its
+// regular files recursively in sorted order, without entering symlinked
+// subdirectories; "@list" adds every path named
+// in list (one per line), and anything else is added as given.
+int collect_inputs(PathList *list, const char *arg);
+void path_list_free(PathList *list);
+
+#endif
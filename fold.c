@@ -0,0 +1,440 @@
+#include "fold.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include "parser.tab.h"
+
+// Constant folding over the expressions of a resolved program, before any
+// engine runs it or it is translated. An operator whose operands are
+// literals becomes the literal it evaluates to, an identity such as x * 1,
+// x + 0 or not not x becomes its operand, and a local whose declaration
+// stores a constant that nothing else replaces reads as that constant, so
+// the folding goes on through it.
+//
+// Every rewrite gives what the interpreter would: the same value, of the
+// same type, with the same runtime error. So integer division by 0 stays,
+// x + 0 only drops the 0 when x is an integer (a float -0.0 would become
+// 0.0), and an identity only drops an operand that has no effects and
+// when what remains is known to be a number, as the operator checks. A
+// node is rewritten in place, keeping its NodeId and its place in a list.
+
+#define AST (&f->in->ctx->ast)
+#define INFO(id) (f->in->info[id])
+
+// What an expression is known to give when it does not fail: a number,
+// an integer, or the integer 0 or 1
+enum { SHAPE_UNKNOWN, SHAPE_NUMBER, SHAPE_INT, SHAPE_TRUTH };
+
+typedef struct {
+    Interp *in;
+    uint8_t *stored;        // per AST_DECL: an assignment or read stores into it
+    uint8_t *constant;      // per AST_DECL: it always holds its folded initializer
+    uint32_t removed;
+} Folder;
+
+static void *xcalloc(size_t n, size_t size) {
+    void *p = calloc(n ? n : 1, size);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static int is_literal(const AstNode *node) {
+    return node->kind == AST_INT || node->kind == AST_FLOAT;
+}
+
+static int truth(const AstNode *node) {
+    return node->kind == AST_INT ? node->v.ival != 0 : node->v.fval != 0;
+}
+
+static double as_float(const AstNode *node) {
+    return node->kind == AST_INT ? (double)node->v.ival : node->v.fval;
+}
+
+// Nodes of an expression tree, argument lists included
+static uint32_t count(Folder *f, NodeId e) {
+    const AstNode *node;
+    uint32_t n = 1;
+    NodeId id;
+
+    if (!e)
+        return 0;
+    node = ast_at(AST, e);
+    switch (node->kind) {
+    case AST_BINARY:
+        return 1 + count(f, node->a) + count(f, node->b);
+    case AST_NOT:
+    case AST_MEMBER:
+        return 1 + count(f, node->a);
+    case AST_INDEX:
+        return 1 + count(f, node->a) + count(f, node->b) + count(f, node->c);
+    case AST_CALL:
+        n += count(f, node->a);
+        if (node->b) {
+            n++;
+            AST_FOREACH(AST, node->b, id)
+                n += count(f, id);
+        }
+        return n;
+    default:
+        return 1;
+    }
+}
+
+static void to_int(Folder *f, NodeId e, int64_t v) {
+    AstNode *node = ast_at(AST, e);
+
+    f->removed += count(f, e) - 1;
+    node->kind = AST_INT;
+    node->op = 0;
+    node->a = node->b = node->c = 0;
+    node->v.ival = v;
+    INFO(e) = 0;
+}
+
+static void to_float(Folder *f, NodeId e, double v) {
+    AstNode *node = ast_at(AST, e);
+
+    f->removed += count(f, e) - 1;
+    node->kind = AST_FLOAT;
+    node->op = 0;
+    node->a = node->b = node->c = 0;
+    node->v.fval = v;
+    INFO(e) = 0;
+}
+
+// Puts the operand x where e was
+static void replace(Folder *f, NodeId e, NodeId x) {
+    AstNode *node = ast_at(AST, e);
+    NodeId next = node->next;
+
+    f->removed += count(f, e) - count(f, x);
+    *node = *ast_at(AST, x);
+    node->next = next;
+    INFO(e) = INFO(x);
+}
+
+static int shape_of_type(int type) {
+    return type == TYPE_INTEGER ? SHAPE_INT : type == TYPE_FLOAT ? SHAPE_NUMBER : SHAPE_UNKNOWN;
+}
+
+// A local declared as a float reads as the integer 0 before its
+// declaration runs, so only the integer declarations pin the type
+static int shape(Folder *f, NodeId e) {
+    const AstNode *node = ast_at(AST, e);
+    NodeId decl;
+    int l, r;
+
+    switch (node->kind) {
+    case AST_INT:
+        return SHAPE_INT;
+    case AST_FLOAT:
+        return SHAPE_NUMBER;
+    case AST_NOT:
+        return SHAPE_TRUTH;
+    case AST_BINARY:
+        if (node->op != PLUS && node->op != MINUS && node->op != MULT && node->op != DIV)
+            return SHAPE_TRUTH;
+        l = shape(f, node->a);
+        r = shape(f, node->b);
+        if (l == SHAPE_UNKNOWN || r == SHAPE_UNKNOWN)
+            return SHAPE_UNKNOWN;
+        return l != SHAPE_NUMBER && r != SHAPE_NUMBER ? SHAPE_INT : SHAPE_NUMBER;
+    case AST_NAME:
+        decl = INFO(e);
+        if (!decl || interp_is_array(f->in, decl))
+            return SHAPE_UNKNOWN;
+        switch (ast_at(AST, decl)->kind) {
+        case AST_DECL:
+        case AST_PARAM:
+        case AST_FIELD:
+            return shape_of_type(interp_decl_type(f->in, decl));
+        default:
+            return SHAPE_UNKNOWN;
+        }
+    case AST_INDEX:
+        // The elements of a parameter are those of whatever array it is given
+        decl = INFO(node->a);
+        if (!decl || ast_at(AST, decl)->kind != AST_FIELD || !ast_at(AST, decl)->b)
+            return SHAPE_UNKNOWN;
+        return shape_of_type(interp_decl_type(f->in, decl));
+    default:
+        return SHAPE_UNKNOWN;
+    }
+}
+
+static int is_number(Folder *f, NodeId e) {
+    return shape(f, e) != SHAPE_UNKNOWN;
+}
+
+static int is_int(Folder *f, NodeId e) {
+    int s = shape(f, e);
+
+    return s == SHAPE_INT || s == SHAPE_TRUTH;
+}
+
+static int is_int_literal(Folder *f, NodeId e, int64_t v) {
+    const AstNode *node = ast_at(AST, e);
+
+    return node->kind == AST_INT && node->v.ival == v;
+}
+
+// Both operands are literals; as arith in interp.c, except that a division
+// by integer 0 is left to fail when it runs
+static void fold_arith(Folder *f, NodeId e) {
+    const AstNode *node = ast_at(AST, e);
+    const AstNode *l = ast_at(AST, node->a), *r = ast_at(AST, node->b);
+
+    if (l->kind == AST_INT && r->kind == AST_INT) {
+        // Unsigned arithmetic wraps where signed would overflow
+        uint64_t a = (uint64_t)l->v.ival, b = (uint64_t)r->v.ival;
+        int64_t x = l->v.ival, y = r->v.ival;
+
+        switch (node->op) {
+        case PLUS: to_int(f, e, (int64_t)(a + b)); break;
+        case MINUS: to_int(f, e, (int64_t)(a - b)); break;
+        case MULT: to_int(f, e, (int64_t)(a * b)); break;
+        case DIV:
+            if (y == -1)
+                to_int(f, e, (int64_t)(0 - a));
+            else if (y != 0)
+                to_int(f, e, x / y);
+            break;
+        case LT: to_int(f, e, x < y); break;
+        case GT: to_int(f, e, x > y); break;
+        case LE: to_int(f, e, x <= y); break;
+        case GE: to_int(f, e, x >= y); break;
+        case EQ: to_int(f, e, x == y); break;
+        case NE: to_int(f, e, x != y); break;
+        }
+    } else {
+        double a = as_float(l), b = as_float(r);
+
+        switch (node->op) {
+        case PLUS: to_float(f, e, a + b); break;
+        case MINUS: to_float(f, e, a - b); break;
+        case MULT: to_float(f, e, a * b); break;
+        case DIV: to_float(f, e, a / b); break;
+        case LT: to_int(f, e, a < b); break;
+        case GT: to_int(f, e, a > b); break;
+        case LE: to_int(f, e, a <= b); break;
+        case GE: to_int(f, e, a >= b); break;
+        case EQ: to_int(f, e, a == b); break;
+        case NE: to_int(f, e, a != b); break;
+        }
+    }
+}
+
+static void fold_expr(Folder *f, NodeId e);
+
+static void fold_binary(Folder *f, NodeId e) {
+    const AstNode *node = ast_at(AST, e);
+    NodeId a = node->a, b = node->b;
+    int op = node->op;
+
+    fold_expr(f, a);
+    fold_expr(f, b);
+    if (op == AND || op == OR) {
+        // A literal left operand decides alone, or leaves the truth of the
+        // right one, which is the operand itself when it is 0 or 1
+        if (is_literal(ast_at(AST, a))) {
+            if (truth(ast_at(AST, a)) == (op == OR))
+                to_int(f, e, op == OR);
+            else if (is_literal(ast_at(AST, b)))
+                to_int(f, e, truth(ast_at(AST, b)));
+            else if (shape(f, b) == SHAPE_TRUTH)
+                replace(f, e, b);
+        }
+        return;
+    }
+    if (is_literal(ast_at(AST, a)) && is_literal(ast_at(AST, b))) {
+        fold_arith(f, e);
+        return;
+    }
+    switch (op) {
+    case MULT:
+        if (is_int_literal(f, b, 1) && is_number(f, a))
+            replace(f, e, a);
+        else if (is_int_literal(f, a, 1) && is_number(f, b))
+            replace(f, e, b);
+        break;
+    case DIV:
+        if (is_int_literal(f, b, 1) && is_number(f, a))
+            replace(f, e, a);
+        break;
+    case PLUS:
+        if (is_int_literal(f, b, 0) && is_int(f, a))
+            replace(f, e, a);
+        else if (is_int_literal(f, a, 0) && is_int(f, b))
+            replace(f, e, b);
+        break;
+    case MINUS:
+        // x - 0 is x for a float too, -0.0 included
+        if (is_int_literal(f, b, 0) && is_number(f, a))
+            replace(f, e, a);
+        break;
+    }
+}
+
+static void fold_expr(Folder *f, NodeId e) {
+    const AstNode *node = ast_at(AST, e);
+    const AstNode *decl;
+    NodeId id;
+
+    switch (node->kind) {
+    case AST_BINARY:
+        fold_binary(f, e);
+        break;
+    case AST_NOT:
+        fold_expr(f, node->a);
+        if (is_literal(ast_at(AST, node->a)))
+            to_int(f, e, !truth(ast_at(AST, node->a)));
+        else if (ast_at(AST, node->a)->kind == AST_NOT && shape(f, ast_at(AST, node->a)->a) == SHAPE_TRUTH)
+            replace(f, e, ast_at(AST, node->a)->a);
+        break;
+    case AST_NAME:
+        if (!INFO(e) || !f->constant[INFO(e)])
+            break;
+        // Stored as the declared type, as interp_convert does
+        decl = ast_at(AST, INFO(e));
+        if (interp_decl_type(f->in, INFO(e)) == TYPE_INTEGER)
+            to_int(f, e, ast_at(AST, decl->b)->kind == AST_INT ? ast_at(AST, decl->b)->v.ival
+                                                                : (int64_t)ast_at(AST, decl->b)->v.fval);
+        else
+            to_float(f, e, as_float(ast_at(AST, decl->b)));
+        break;
+    case AST_INDEX:
+        fold_expr(f, node->b);
+        if (node->c)
+            fold_expr(f, node->c);
+        break;
+    case AST_CALL:
+        AST_FOREACH(AST, node->b, id)
+            fold_expr(f, id);
+        break;
+    default:
+        break;
+    }
+}
+
+// ---- statements ----
+
+static void mark_stores(Folder *f, NodeId s) {
+    const AstNode *node = ast_at(AST, s);
+    NodeId id;
+
+    switch (node->kind) {
+    case AST_BLOCK:
+        AST_FOREACH(AST, node->a, id)
+            mark_stores(f, id);
+        break;
+    case AST_ASSIGN:
+    case AST_READ:
+        if (ast_at(AST, node->a)->kind == AST_NAME && INFO(node->a))
+            f->stored[INFO(node->a)] = 1;
+        break;
+    case AST_IF:
+        mark_stores(f, node->b);
+        if (node->c)
+            mark_stores(f, node->c);
+        break;
+    case AST_WHILE:
+        mark_stores(f, node->b);
+        break;
+    default:
+        break;
+    }
+}
+
+// A target's indexes are values; the name it stores into is not
+static void fold_target(Folder *f, NodeId target) {
+    const AstNode *node = ast_at(AST, target);
+
+    if (node->kind == AST_INDEX) {
+        fold_expr(f, node->b);
+        if (node->c)
+            fold_expr(f, node->c);
+    }
+}
+
+// A declaration in a statement list runs before anything its name is
+// visible to; one that is the whole body of an if or while may not run
+// at all, leaving its slot as it was
+static void fold_stmt(Folder *f, NodeId s, int listed) {
+    const AstNode *node = ast_at(AST, s);
+    int type;
+    NodeId id;
+
+    switch (node->kind) {
+    case AST_DECL:
+        if (!node->b)
+            break;
+        fold_expr(f, node->b);
+        type = interp_decl_type(f->in, s);
+        if (listed && !f->stored[s] && (type == TYPE_INTEGER || type == TYPE_FLOAT) &&
+            is_literal(ast_at(AST, node->b)))
+            f->constant[s] = 1;
+        break;
+    case AST_BLOCK:
+        AST_FOREACH(AST, node->a, id)
+            fold_stmt(f, id, 1);
+        break;
+    case AST_ASSIGN:
+        fold_expr(f, node->b);
+        fold_target(f, node->a);
+        break;
+    case AST_IF:
+        fold_expr(f, node->a);
+        fold_stmt(f, node->b, 0);
+        if (node->c)
+            fold_stmt(f, node->c, 0);
+        break;
+    case AST_WHILE:
+        fold_expr(f, node->a);
+        fold_stmt(f, node->b, 0);
+        break;
+    case AST_READ:
+        fold_target(f, node->a);
+        break;
+    case AST_WRITE:
+    case AST_RETURN:
+        if (node->a)
+            fold_expr(f, node->a);
+        break;
+    default:
+        break;
+    }
+}
+
+static void fold_list(Folder *f, NodeId list) {
+    NodeId id;
+
+    AST_FOREACH(AST, list, id)
+        mark_stores(f, id);
+    AST_FOREACH(AST, list, id)
+        fold_stmt(f, id, 1);
+}
+
+uint32_t fold_program(Interp *in) {
+    const AstNode *program = ast_at(&in->ctx->ast, in->ctx->root);
+    Folder state;
+    Folder *f = &state;
+    uint32_t i;
+    NodeId id;
+
+    f->in = in;
+    f->stored = xcalloc(in->ctx->ast.count, 1);
+    f->constant = xcalloc(in->ctx->ast.count, 1);
+    f->removed = 0;
+    for (i = 0; i < in->classes.count; i++) {
+        AST_FOREACH(AST, ast_at(AST, in->classes.classes[i].decl)->b, id) {
+            if (ast_at(AST, id)->kind == AST_METHOD)
+                fold_list(f, ast_at(AST, id)->c);
+        }
+    }
+    fold_list(f, program->b);
+    free(f->stored);
+    free(f->constant);
+    return f->removed;
+}
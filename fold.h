@@ -0,0 +1,11 @@
+#ifndef FOLD_H
+#define FOLD_H
+
+#include <stdint.h>
+#include "runtime.h"
+
+// Folds the constant parts of the expressions of a resolved program in
+// place (see fold.c). Returns how many nodes dropped out of the trees.
+uint32_t fold_program(Interp *in);
+
+#endif
@@ -0,0 +1,330 @@
+#include "hierarchy.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MEMBER_MIN_SLOTS 8
+
+enum { WHITE, GRAY, BLACK };
+
+typedef struct {
+    const uint32_t *items;
+    uint32_t len;
+    uint32_t pos;
+} MergeList;
+
+// Scratch space for building, sized once for the whole program
+typedef struct {
+    uint32_t *tails;        // per class: lists holding it past their head
+    uint32_t *mark;         // per class: index + 1 of the class being linearized
+    uint32_t *stack;        // DFS frames: class, next base
+    uint32_t *order;        // classes with their bases first
+    MergeList *lists;
+    uint32_t *out;
+    size_t out_capacity;
+} Scratch;
+
+static void *xcalloc(size_t n, size_t size) {
+    void *p = calloc(n ? n : 1, size);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static uint32_t slot_of(SymbolId name, uint32_t mask) {
+    return (name * 0x9E3779B1u) & mask;
+}
+
+static uint32_t table_size(uint32_t count) {
+    uint32_t n = MEMBER_MIN_SLOTS;
+
+    while (n < count * 2)
+        n *= 2;
+    return n;
+}
+
+uint32_t hierarchy_find(const Hierarchy *h, SymbolId name) {
+    uint32_t slot;
+
+    if (!h->slots)
+        return CLASS_NONE;
+    for (slot = slot_of(name, h->mask); h->slots[slot]; slot = (slot + 1) & h->mask) {
+        if (h->classes[h->slots[slot] - 1].name == name)
+            return h->slots[slot] - 1;
+    }
+    return CLASS_NONE;
+}
+
+// Bases that name no class are left out here and reported by the caller;
+// a base named twice adds nothing the first mention did not
+static void resolve_bases(Hierarchy *h, Scratch *s, uint32_t cls) {
+    ClassInfo *c = &h->classes[cls];
+    NodeId list = ast_at(h->ast, c->decl)->a;
+    uint32_t n = 0;
+    NodeId id;
+
+    AST_FOREACH(h->ast, list, id)
+        n++;
+    c->bases = arena_alloc(&h->arena, (n ? n : 1) * sizeof(uint32_t));
+    AST_FOREACH(h->ast, list, id) {
+        uint32_t base = hierarchy_find(h, ast_at(h->ast, id)->v.sym);
+        if (base == CLASS_NONE || s->mark[base] == cls + 1)
+            continue;
+        s->mark[base] = cls + 1;
+        c->bases[c->nbases++] = base;
+    }
+}
+
+// Depth-first over the isa edges. An edge back to a class still on the
+// stack closes a cycle and is dropped, so what remains is acyclic; the
+// finishing order puts every class after its bases.
+static uint32_t break_cycles(Hierarchy *h, Scratch *s) {
+    uint8_t *color = xcalloc(h->count, 1);
+    uint32_t done = 0;
+    uint32_t root;
+
+    for (root = 0; root < h->count; root++) {
+        uint32_t depth = 0;
+
+        if (color[root] != WHITE)
+            continue;
+        color[root] = GRAY;
+        s->stack[0] = root;
+        s->stack[1] = 0;
+        depth = 1;
+        while (depth) {
+            uint32_t *frame = &s->stack[(depth - 1) * 2];
+            ClassInfo *c = &h->classes[frame[0]];
+            uint32_t base;
+
+            if (frame[1] == c->nbases) {
+                color[frame[0]] = BLACK;
+                s->order[done++] = frame[0];
+                depth--;
+                continue;
+            }
+            base = c->bases[frame[1]];
+            if (color[base] == GRAY) {
+                c->cycle_base = base;
+                memmove(&c->bases[frame[1]], &c->bases[frame[1] + 1],
+                        (c->nbases - frame[1] - 1) * sizeof(uint32_t));
+                c->nbases--;
+            } else if (color[base] == WHITE) {
+                frame[1]++;
+                color[base] = GRAY;
+                s->stack[depth * 2] = base;
+                s->stack[depth * 2 + 1] = 0;
+                depth++;
+            } else {
+                frame[1]++;
+            }
+        }
+    }
+    free(color);
+    return done;
+}
+
+static void advance(MergeList *l, uint32_t *tails) {
+    if (++l->pos < l->len)
+        tails[l->items[l->pos]]--;
+}
+
+// C3: the class, then a merge of its bases' linearizations and the base
+// list itself that keeps the order of each. The next class taken is the
+// first head not waiting in the tail of another list; tails counts those
+// waits, so a candidate is checked in constant time. If no head qualifies
+// the bases are inconsistent, and the first head is taken anyway.
+static void linearize(Hierarchy *h, Scratch *s, uint32_t cls) {
+    ClassInfo *c = &h->classes[cls];
+    uint32_t k = c->nbases + 1;
+    size_t total = 1;
+    uint32_t n = 0;
+    uint32_t i, j;
+
+    for (i = 0; i < c->nbases; i++) {
+        const ClassInfo *b = &h->classes[c->bases[i]];
+        s->lists[i] = (MergeList){ b->mro, b->nmro, 0 };
+        total += b->nmro;
+    }
+    s->lists[c->nbases] = (MergeList){ c->bases, c->nbases, 0 };
+    if (total > s->out_capacity) {
+        free(s->out);
+        s->out_capacity = total * 2;
+        s->out = xcalloc(s->out_capacity, sizeof(uint32_t));
+    }
+    for (i = 0; i < k; i++) {
+        for (j = 1; j < s->lists[i].len; j++)
+            s->tails[s->lists[i].items[j]]++;
+    }
+    s->out[n++] = cls;
+    s->mark[cls] = cls + 1;
+    for (;;) {
+        uint32_t pick = CLASS_NONE;
+
+        for (i = 0; i < k && pick == CLASS_NONE; i++) {
+            const MergeList *l = &s->lists[i];
+            if (l->pos < l->len && s->tails[l->items[l->pos]] == 0)
+                pick = l->items[l->pos];
+        }
+        for (i = 0; i < k && pick == CLASS_NONE; i++) {
+            const MergeList *l = &s->lists[i];
+            if (l->pos < l->len) {
+                pick = l->items[l->pos];
+                c->inconsistent = 1;
+            }
+        }
+        if (pick == CLASS_NONE)
+            break;
+        s->out[n++] = pick;
+        s->mark[pick] = cls + 1;
+        for (i = 0; i < k; i++) {
+            MergeList *l = &s->lists[i];
+            while (l->pos < l->len && s->mark[l->items[l->pos]] == cls + 1)
+                advance(l, s->tails);
+        }
+    }
+    c->mro = arena_alloc(&h->arena, n * sizeof(uint32_t));
+    memcpy(c->mro, s->out, n * sizeof(uint32_t));
+    c->nmro = n;
+}
+
+// Builds the hierarchy of the AST_CLASS nodes in the list classes. A name
+// declared twice refers to its first class.
+void hierarchy_build(Hierarchy *h, const Ast *ast, NodeId classes) {
+    Scratch s = {0};
+    uint32_t max_bases = 0;
+    uint32_t i, n;
+    NodeId id;
+
+    memset(h, 0, sizeof(*h));
+    h->ast = ast;
+    for (i = 0; i < HIERARCHY_LOCKS; i++)
+        pthread_mutex_init(&h->locks[i], NULL);
+    AST_FOREACH(ast, classes, id) {
+        if (ast_at(ast, id)->kind == AST_CLASS)
+            h->count++;
+    }
+    if (h->count == 0)
+        return;
+    h->classes = arena_alloc(&h->arena, h->count * sizeof(ClassInfo));
+    n = table_size(h->count);
+    h->slots = arena_alloc(&h->arena, n * sizeof(uint32_t));
+    memset(h->slots, 0, n * sizeof(uint32_t));
+    h->mask = n - 1;
+    i = 0;
+    AST_FOREACH(ast, classes, id) {
+        const AstNode *node = ast_at(ast, id);
+        ClassInfo *c;
+        uint32_t slot;
+
+        if (node->kind != AST_CLASS)
+            continue;
+        c = &h->classes[i];
+        memset(c, 0, sizeof(*c));
+        c->name = node->v.sym;
+        c->decl = id;
+        c->cycle_base = CLASS_NONE;
+        if (hierarchy_find(h, c->name) == CLASS_NONE) {
+            for (slot = slot_of(c->name, h->mask); h->slots[slot]; slot = (slot + 1) & h->mask)
+                ;
+            h->slots[slot] = i + 1;
+        }
+        i++;
+    }
+
+    s.tails = xcalloc(h->count, sizeof(uint32_t));
+    s.mark = xcalloc(h->count, sizeof(uint32_t));
+    s.stack = xcalloc(h->count * 2, sizeof(uint32_t));
+    s.order = xcalloc(h->count, sizeof(uint32_t));
+    for (i = 0; i < h->count; i++) {
+        resolve_bases(h, &s, i);
+        if (h->classes[i].nbases > max_bases)
+            max_bases = h->classes[i].nbases;
+    }
+    s.lists = xcalloc(max_bases + 1, sizeof(MergeList));
+    memset(s.mark, 0, h->count * sizeof(uint32_t));
+    n = break_cycles(h, &s);
+    for (i = 0; i < n; i++)
+        linearize(h, &s, s.order[i]);
+    free(s.tails);
+    free(s.mark);
+    free(s.stack);
+    free(s.order);
+    free(s.lists);
+    free(s.out);
+}
+
+static Member *probe(Member *table, uint32_t mask, SymbolId name) {
+    uint32_t slot;
+
+    for (slot = slot_of(name, mask); table[slot].decl; slot = (slot + 1) & mask) {
+        if (table[slot].name == name)
+            return &table[slot];
+    }
+    return &table[slot];
+}
+
+// Members of the whole linearization, the first in lookup order winning.
+// Tables are allocated one by one, since the arena is not shared between
+// threads.
+static Member *flatten(Hierarchy *h, ClassInfo *c) {
+    Member *members;
+    uint32_t count = 0;
+    uint32_t i, n;
+    NodeId id;
+
+    for (i = 0; i < c->nmro; i++) {
+        AST_FOREACH(h->ast, ast_at(h->ast, h->classes[c->mro[i]].decl)->b, id)
+            count++;
+    }
+    n = table_size(count);
+    members = xcalloc(n, sizeof(Member));
+    c->mask = n - 1;
+    for (i = 0; i < c->nmro; i++) {
+        AST_FOREACH(h->ast, ast_at(h->ast, h->classes[c->mro[i]].decl)->b, id) {
+            const AstNode *node = ast_at(h->ast, id);
+            Member *m;
+
+            if (node->kind != AST_FIELD && node->kind != AST_METHOD)
+                continue;
+            m = probe(members, c->mask, node->v.sym);
+            if (!m->decl) {
+                m->name = node->v.sym;
+                m->decl = id;
+            }
+        }
+    }
+    return members;
+}
+
+// The declaration name resolves to in class cls, or 0
+NodeId hierarchy_member(Hierarchy *h, uint32_t cls, SymbolId name) {
+    ClassInfo *c = &h->classes[cls];
+    Member *members = __atomic_load_n(&c->members, __ATOMIC_ACQUIRE);
+
+    if (!members) {
+        pthread_mutex_t *lock = &h->locks[cls % HIERARCHY_LOCKS];
+
+        pthread_mutex_lock(lock);
+        members = c->members;
+        if (!members) {
+            members = flatten(h, c);
+            __atomic_store_n(&c->members, members, __ATOMIC_RELEASE);
+        }
+        pthread_mutex_unlock(lock);
+    }
+    return probe(members, c->mask, name)->decl;
+}
+
+void hierarchy_free(Hierarchy *h) {
+    uint32_t i;
+
+    for (i = 0; i < h->count; i++)
+        free(h->classes[i].members);
+    for (i = 0; i < HIERARCHY_LOCKS; i++)
+        pthread_mutex_destroy(&h->locks[i]);
+    arena_free(&h->arena);
+    memset(h, 0, sizeof(*h));
+}
@@ -0,0 +1,53 @@
+#ifndef HIERARCHY_H
+#define HIERARCHY_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include "arena.h"
+#include "ast.h"
+#include "intern.h"
+
+#define CLASS_NONE UINT32_MAX
+#define HIERARCHY_LOCKS 64         // stripes guarding the building of member tables
+
+typedef struct {
+    SymbolId name;
+    NodeId decl;            // AST_FIELD or AST_METHOD; 0 marks an empty slot
+} Member;
+
+typedef struct {
+    SymbolId name;
+    NodeId decl;            // the AST_CLASS node
+    uint32_t *bases;        // resolved isa list, without repeats or cycles
+    uint32_t nbases;
+    uint32_t cycle_base;    // a base dropped because it inherits from this class, or CLASS_NONE
+    int inconsistent;       // the bases admit no C3 order; mro is a best effort
+    uint32_t *mro;          // this class, then its ancestors in lookup order
+    uint32_t nmro;
+    Member *members;        // own and inherited members, built on first lookup
+    uint32_t mask;          // set before members is published
+} ClassInfo;
+
+// The classes of one program and the isa graph between them. Every class
+// gets a C3 linearization of its ancestors, so a member is looked up in a
+// fixed order whatever the shape of the hierarchy, and a flattened member
+// table in which that lookup is one hash probe. The tables are built on
+// first use, since each repeats the members of all ancestors. Lookups may
+// come from several threads: a table is built under its stripe's lock and
+// published with a release store, so reading a built table takes no lock.
+typedef struct {
+    const Ast *ast;
+    ClassInfo *classes;     // in declaration order
+    uint32_t count;
+    uint32_t *slots;        // open addressing by name, holds index + 1 (0 = empty)
+    uint32_t mask;
+    Arena arena;
+    pthread_mutex_t locks[HIERARCHY_LOCKS];
+} Hierarchy;
+
+void hierarchy_build(Hierarchy *h, const Ast *ast, NodeId classes);
+uint32_t hierarchy_find(const Hierarchy *h, SymbolId name);
+NodeId hierarchy_member(Hierarchy *h, uint32_t cls, SymbolId name);
+void hierarchy_free(Hierarchy *h);
+
+#endif
@@ -0,0 +1,89 @@
+#include "intern.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define INTERN_INITIAL_SLOTS 1024
+
+static uint32_t intern_hash(const char *s, size_t len) {
+    uint32_t h = 2166136261u;  // FNV-1a
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static void *intern_xrealloc(void *p, size_t size) {
+    p = realloc(p, size);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static void intern_grow_slots(InternPool *pool) {
+    uint32_t nslots = pool->slots ? (pool->mask + 1) * 2 : INTERN_INITIAL_SLOTS;
+    uint32_t i;
+
+    free(pool->slots);
+    pool->slots = calloc(nslots, sizeof(uint32_t));
+    if (!pool->slots) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    pool->mask = nslots - 1;
+    for (i = 0; i < pool->count; i++) {
+        uint32_t slot = pool->entries[i].hash & pool->mask;
+        while (pool->slots[slot])
+            slot = (slot + 1) & pool->mask;
+        pool->slots[slot] = i + 1;
+    }
+}
+
+SymbolId intern(InternPool *pool, const char *s, size_t len) {
+    uint32_t hash = intern_hash(s, len);
+    uint32_t slot;
+    InternEntry *e;
+
+    pool->bytes_requested += len + 1;
+    if (!pool->slots)
+        intern_grow_slots(pool);
+
+    for (slot = hash & pool->mask; pool->slots[slot]; slot = (slot + 1) & pool->mask) {
+        e = &pool->entries[pool->slots[slot] - 1];
+        if (e->hash == hash && e->len == len && memcmp(e->str, s, len) == 0)
+            return pool->slots[slot] - 1;
+    }
+
+    if (pool->count == pool->capacity) {
+        pool->capacity = pool->capacity ? pool->capacity * 2 : 256;
+        pool->entries = intern_xrealloc(pool->entries, pool->capacity * sizeof(InternEntry));
+    }
+    e = &pool->entries[pool->count];
+    if (pool->borrow) {
+        e->str = s;
+    } else {
+        e->str = arena_strndup(&pool->arena, s, len);
+        pool->bytes_stored += len + 1;
+    }
+    e->len = (uint32_t)len;
+    e->hash = hash;
+    pool->slots[slot] = pool->count + 1;
+    pool->count++;
+
+    // Keep the load factor at or below one half
+    if (pool->count * 2 > pool->mask + 1)
+        intern_grow_slots(pool);
+    return pool->count - 1;
+}
+
+void intern_free(InternPool *pool) {
+    arena_free(&pool->arena);
+    free(pool->entries);
+    free(pool->slots);
+    memset(pool, 0, sizeof(*pool));
+}
@@ -0,0 +1,46 @@
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+
+typedef uint32_t SymbolId;
+
+typedef struct {
+    const char *str;
+    uint32_t len;
+    uint32_t hash;
+} InternEntry;
+
+// Hash-consed string pool: every distinct string is stored once and
+// identified by a dense 32-bit id, so names compare by integer.
+// A zero-initialized InternPool is ready to use.
+//
+// With borrow set, new strings point into the caller's buffer instead of
+// being copied; they are then not NUL-terminated, so print them with
+// intern_len, and the buffer must outlive the pool.
+typedef struct {
+    Arena arena;
+    InternEntry *entries;   // id -> string
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t *slots;        // open addressing, holds id + 1 (0 = empty)
+    uint32_t mask;
+    size_t bytes_requested; // bytes a strdup per call would have used
+    size_t bytes_stored;    // bytes actually kept
+    int borrow;
+} InternPool;
+
+SymbolId intern(InternPool *pool, const char *s, size_t len);
+void intern_free(InternPool *pool);
+
+static inline const char *intern_str(const InternPool *pool, SymbolId id) {
+    return pool->entries[id].str;
+}
+
+static inline uint32_t intern_len(const InternPool *pool, SymbolId id) {
+    return pool->entries[id].len;
+}
+
+#endif
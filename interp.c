@@ -0,0 +1,986 @@
+#include "interp.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "fold.h"
+#include "parser.tab.h"
+#include "runtime.h"
+#include "scope.h"
+#include "vm.h"
+
+// Tree-walking interpreter over the tree of a finished parse. A resolve
+// pass first binds every name in a method body to its declaration, using
+// the same ScopeTable walk as the checks, and gives each parameter and
+// local a slot in the method's frame and each field a program-wide id.
+// Running then follows node links only: a local is a frame slot, a field
+// is a slot of the object found through its class's layout, and a method
+// is looked up in the flattened member table of the receiver's class.
+//
+// Values are integers, floats, strings (only for write), objects and
+// arrays. An object comes into being the first time a variable of class
+// type is used as one, so declaring one costs nothing and a class may
+// hold a field of its own type. Objects and arrays live until the end of
+// the run. A 2-D field declares its first dimension by name, which has no
+// value when the object is made, so its rows grow as they are indexed.
+
+#define INTERP_MAX_ROWS (1u << 24)     // growth limit of a 2-D array's first dimension
+
+typedef enum { FLOW_NEXT, FLOW_RETURN, FLOW_HALT } Flow;
+
+typedef struct {
+    Object *self;
+    Value *locals;
+} Frame;
+
+#define AST (&in->ctx->ast)
+#define NAME(sym) (int)intern_len(&in->ctx->symbol_table.strings, (sym)), \
+                  intern_str(&in->ctx->symbol_table.strings, (sym))
+
+const Value interp_zero = { VAL_INT, { 0 } };
+
+#define zero interp_zero
+
+static void *xcalloc(size_t n, size_t size) {
+    void *p = calloc(n ? n : 1, size);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+// Reports the first error and stops the run; statements check halted
+// as they finish, so evaluation just goes on with a dummy value
+void interp_error(Interp *in, uint32_t line, const char *fmt, ...) {
+    va_list ap;
+
+    if (in->halted)
+        return;
+    in->halted = 1;
+    fflush(in->ctx->out);
+    fprintf(in->ctx->err, "Runtime Error at line %u: ", line);
+    va_start(ap, fmt);
+    vfprintf(in->ctx->err, fmt, ap);
+    va_end(ap);
+    fputc('\n', in->ctx->err);
+}
+
+static uint32_t list_length(const Ast *ast, NodeId list) {
+    uint32_t n = 0;
+    NodeId id;
+
+    AST_FOREACH(ast, list, id)
+        n++;
+    return n;
+}
+
+// TYPE_* of a declaration or method; a method without a type returns nothing
+int interp_decl_type(Interp *in, NodeId decl) {
+    NodeId type = ast_at(AST, decl)->kind == AST_METHOD ? ast_at(AST, decl)->b : ast_at(AST, decl)->a;
+
+    return type ? ast_at(AST, type)->op : TYPE_VOID;
+}
+
+int interp_is_array(Interp *in, NodeId decl) {
+    const AstNode *node = ast_at(AST, decl);
+
+    return (node->kind == AST_FIELD && node->b) || (node->kind == AST_PARAM && (node->flags & AST_ARRAY));
+}
+
+// ---- resolving ----
+
+static void resolve_name(Interp *in, ScopeTable *scopes, uint32_t cls, NodeId name) {
+    const Symbol *sym = scope_lookup(scopes, ast_at(AST, name)->v.sym);
+
+    if (sym)
+        in->info[name] = sym->decl;
+    else if (cls != CLASS_NONE)
+        in->info[name] = hierarchy_member(&in->classes, cls, ast_at(AST, name)->v.sym);
+}
+
+static void resolve_expr(Interp *in, ScopeTable *scopes, uint32_t cls, NodeId expr) {
+    const AstNode *node = ast_at(AST, expr);
+    NodeId id;
+
+    switch (node->kind) {
+    case AST_BINARY:
+        resolve_expr(in, scopes, cls, node->a);
+        resolve_expr(in, scopes, cls, node->b);
+        break;
+    case AST_NOT:
+        resolve_expr(in, scopes, cls, node->a);
+        break;
+    case AST_NAME:
+        resolve_name(in, scopes, cls, expr);
+        break;
+    case AST_MEMBER:
+        resolve_name(in, scopes, cls, node->a);
+        break;
+    case AST_INDEX:
+        resolve_name(in, scopes, cls, node->a);
+        resolve_expr(in, scopes, cls, node->b);
+        if (node->c)
+            resolve_expr(in, scopes, cls, node->c);
+        break;
+    case AST_CALL:
+        if (node->op == CALL_METHOD)
+            resolve_name(in, scopes, cls, node->a);
+        AST_FOREACH(AST, node->b, id)
+            resolve_expr(in, scopes, cls, id);
+        break;
+    default:
+        break;
+    }
+}
+
+// Every declaration gets a slot of its own, so slots need no reuse
+// bookkeeping as blocks open and close
+static void resolve_stmt(Interp *in, ScopeTable *scopes, uint32_t cls, NodeId stmt, uint32_t *nslots) {
+    const AstNode *node = ast_at(AST, stmt);
+    NodeId id;
+
+    switch (node->kind) {
+    case AST_DECL:
+        if (node->b)
+            resolve_expr(in, scopes, cls, node->b);
+        scope_declare(scopes, node->v.sym, SYM_LOCAL, stmt);
+        in->info[stmt] = (*nslots)++;
+        break;
+    case AST_BLOCK:
+        scope_push(scopes, list_length(AST, node->a));
+        AST_FOREACH(AST, node->a, id)
+            resolve_stmt(in, scopes, cls, id, nslots);
+        scope_pop(scopes);
+        break;
+    case AST_ASSIGN:
+        resolve_expr(in, scopes, cls, node->a);
+        resolve_expr(in, scopes, cls, node->b);
+        break;
+    case AST_IF:
+        resolve_expr(in, scopes, cls, node->a);
+        resolve_stmt(in, scopes, cls, node->b, nslots);
+        if (node->c)
+            resolve_stmt(in, scopes, cls, node->c, nslots);
+        break;
+    case AST_WHILE:
+        resolve_expr(in, scopes, cls, node->a);
+        resolve_stmt(in, scopes, cls, node->b, nslots);
+        break;
+    case AST_READ:
+    case AST_WRITE:
+    case AST_RETURN:
+        if (node->a)
+            resolve_expr(in, scopes, cls, node->a);
+        break;
+    default:
+        break;
+    }
+}
+
+static void resolve_method(Interp *in, ScopeTable *scopes, uint32_t cls, NodeId method) {
+    const AstNode *node = ast_at(AST, method);
+    uint32_t nslots = 0;
+    NodeId id;
+
+    scope_push(scopes, list_length(AST, node->a) + list_length(AST, node->c));
+    AST_FOREACH(AST, node->a, id) {
+        scope_declare(scopes, ast_at(AST, id)->v.sym, SYM_PARAM, id);
+        in->info[id] = nslots++;
+    }
+    AST_FOREACH(AST, node->c, id)
+        resolve_stmt(in, scopes, cls, id, &nslots);
+    scope_pop(scopes);
+    in->info[method] = nslots;
+}
+
+static void resolve_program(Interp *in, const AstNode *program) {
+    ScopeTable scopes = {0};
+    uint32_t i;
+    NodeId id;
+
+    for (i = 0; i < in->classes.count; i++) {
+        AST_FOREACH(AST, ast_at(AST, in->classes.classes[i].decl)->b, id) {
+            if (ast_at(AST, id)->kind == AST_FIELD)
+                in->info[id] = in->nfields++;
+        }
+    }
+    for (i = 0; i < in->classes.count; i++) {
+        AST_FOREACH(AST, ast_at(AST, in->classes.classes[i].decl)->b, id) {
+            if (ast_at(AST, id)->kind == AST_METHOD)
+                resolve_method(in, &scopes, i, id);
+        }
+    }
+    if (program->b) {
+        scope_push(&scopes, list_length(AST, program->b));
+        AST_FOREACH(AST, program->b, id)
+            resolve_stmt(in, &scopes, CLASS_NONE, id, &in->top_frame);
+        scope_pop(&scopes);
+    }
+    scope_table_free(&scopes);
+}
+
+// ---- objects and arrays ----
+
+const ClassLayout *interp_layout(Interp *in, uint32_t cls) {
+    ClassLayout *l = &in->layouts[cls];
+    const ClassInfo *info = &in->classes.classes[cls];
+    uint32_t i, n = 0;
+    NodeId id;
+
+    if (l->slot_of)
+        return l;
+    for (i = 0; i < info->nmro; i++) {
+        AST_FOREACH(AST, ast_at(AST, in->classes.classes[info->mro[i]].decl)->b, id)
+            n += ast_at(AST, id)->kind == AST_FIELD;
+    }
+    l->slot_of = xcalloc(in->nfields, sizeof(int32_t));
+    memset(l->slot_of, 0xff, (size_t)in->nfields * sizeof(int32_t));
+    l->fields = xcalloc(n, sizeof(NodeId));
+    for (i = info->nmro; i-- > 0;) {
+        AST_FOREACH(AST, ast_at(AST, in->classes.classes[info->mro[i]].decl)->b, id) {
+            if (ast_at(AST, id)->kind == AST_FIELD) {
+                l->slot_of[in->info[id]] = (int32_t)l->nslots;
+                l->fields[l->nslots++] = id;
+            }
+        }
+    }
+    return l;
+}
+
+// Initial value of a scalar of the given type; objects are made on first use
+static Value zero_of(int type) {
+    Value v = zero;
+
+    if (type == TYPE_FLOAT) {
+        v.kind = VAL_FLOAT;
+        v.v.f = 0;
+    } else if (type == TYPE_CLASS) {
+        v.kind = VAL_OBJECT;
+        v.v.obj = NULL;
+    }
+    return v;
+}
+
+static Array *new_array(Interp *in, NodeId decl) {
+    const AstNode *node = ast_at(AST, decl);
+    const AstNode *first = ast_at(AST, node->b);
+    Array *arr = arena_alloc(&in->heap, sizeof(Array));
+    Value init = zero_of(interp_decl_type(in, decl));
+    uint32_t i;
+
+    arr->decl = decl;
+    arr->cols = node->c ? (uint32_t)ast_at(AST, node->c)->v.ival : 0;
+    arr->rows = first->kind == AST_INT ? (uint32_t)first->v.ival : 0;
+    arr->data = NULL;
+    if (arr->rows) {
+        uint32_t n = arr->rows * (arr->cols ? arr->cols : 1);
+        arr->data = arena_alloc(&in->heap, (size_t)n * sizeof(Value));
+        for (i = 0; i < n; i++)
+            arr->data[i] = init;
+    }
+    return arr;
+}
+
+static Object *new_object(Interp *in, uint32_t cls) {
+    const ClassLayout *l = interp_layout(in, cls);
+    Object *obj = arena_alloc(&in->heap, sizeof(Object) + (size_t)l->nslots * sizeof(Value));
+    uint32_t i;
+
+    obj->cls = cls;
+    for (i = 0; i < l->nslots; i++) {
+        if (ast_at(AST, l->fields[i])->b) {
+            obj->slots[i].kind = VAL_ARRAY;
+            obj->slots[i].v.arr = new_array(in, l->fields[i]);
+        } else {
+            obj->slots[i] = zero_of(interp_decl_type(in, l->fields[i]));
+        }
+    }
+    return obj;
+}
+
+Value *interp_element(Interp *in, Array *arr, int64_t row, int64_t col, int used, uint32_t line) {
+    const AstNode *decl = ast_at(AST, arr->decl);
+    int dims = arr->cols ? 2 : 1;
+
+    if (used != dims) {
+        interp_error(in, line, "'%.*s' has %d dimensions but is indexed with %d", NAME(decl->v.sym), dims, used);
+        return NULL;
+    }
+    if (row < 0 || col < 0 || (dims == 2 && col >= arr->cols) ||
+        (row >= arr->rows && (ast_at(AST, decl->b)->kind == AST_INT || row >= INTERP_MAX_ROWS))) {
+        interp_error(in, line, "index %lld is out of range for '%.*s'",
+                      (long long)(row < 0 || row >= arr->rows ? row : col), NAME(decl->v.sym));
+        return NULL;
+    }
+    if (row >= arr->rows) {
+        uint32_t rows = arr->rows ? arr->rows : 8;
+        uint32_t width = arr->cols ? arr->cols : 1;
+        Value init = zero_of(interp_decl_type(in, arr->decl));
+        Value *data;
+        size_t i;
+
+        while (rows <= row)
+            rows *= 2;
+        if (rows > INTERP_MAX_ROWS)
+            rows = INTERP_MAX_ROWS;
+        data = arena_alloc(&in->heap, (size_t)rows * width * sizeof(Value));
+        if (arr->rows)
+            memcpy(data, arr->data, (size_t)arr->rows * width * sizeof(Value));
+        for (i = (size_t)arr->rows * width; i < (size_t)rows * width; i++)
+            data[i] = init;
+        arr->data = data;
+        arr->rows = rows;
+    }
+    return &arr->data[dims == 2 ? row * arr->cols + col : row];
+}
+
+// ---- variables ----
+
+static Flow exec_list(Interp *in, Frame *f, NodeId list);
+
+static Value eval(Interp *in, Frame *f, NodeId expr);
+
+static Value *field_of(Interp *in, Object *obj, NodeId decl, uint32_t line) {
+    int32_t slot = interp_layout(in, obj->cls)->slot_of[in->info[decl]];
+
+    if (slot < 0) {
+        interp_error(in, line, "an object of class '%.*s' has no field '%.*s'",
+                      NAME(in->classes.classes[obj->cls].name), NAME(ast_at(AST, decl)->v.sym));
+        return NULL;
+    }
+    return &obj->slots[slot];
+}
+
+// Storage of the variable an AST_NAME is bound to, or NULL after reporting
+static Value *variable(Interp *in, Frame *f, NodeId name) {
+    const AstNode *node = ast_at(AST, name);
+    NodeId decl = in->info[name];
+
+    switch (decl ? ast_at(AST, decl)->kind : AST_ERROR) {
+    case AST_DECL:
+    case AST_PARAM:
+        return &f->locals[in->info[decl]];
+    case AST_FIELD:
+        return field_of(in, f->self, decl, node->line);
+    case AST_METHOD:
+        interp_error(in, node->line, "'%.*s' is not a variable", NAME(node->v.sym));
+        return NULL;
+    default:
+        interp_error(in, node->line, "'%.*s' is not declared", NAME(node->v.sym));
+        return NULL;
+    }
+}
+
+// Object a name refers to, made now if the variable has none yet
+static Object *receiver(Interp *in, Frame *f, NodeId name) {
+    const AstNode *node = ast_at(AST, name);
+    Value *v = variable(in, f, name);
+    uint32_t cls;
+
+    if (!v)
+        return NULL;
+    if (v->kind != VAL_OBJECT) {
+        interp_error(in, node->line, "'%.*s' is not an object", NAME(node->v.sym));
+        return NULL;
+    }
+    if (!v->v.obj) {
+        NodeId type = ast_at(AST, in->info[name])->a;
+        cls = hierarchy_find(&in->classes, ast_at(AST, type)->v.sym);
+        if (cls == CLASS_NONE) {
+            interp_error(in, node->line, "class '%.*s' is not declared", NAME(ast_at(AST, type)->v.sym));
+            return NULL;
+        }
+        v->v.obj = new_object(in, cls);
+    }
+    return v->v.obj;
+}
+
+static int64_t eval_index(Interp *in, Frame *f, NodeId expr) {
+    Value v = eval(in, f, expr);
+
+    if (v.kind == VAL_INT)
+        return v.v.i;
+    if (v.kind == VAL_FLOAT)
+        return (int64_t)v.v.f;
+    interp_error(in, ast_at(AST, expr)->line, "index is not a number");
+    return 0;
+}
+
+// Storage an assignment target or operand names, with the declared type
+// of what is stored there; NULL after reporting
+static Value *place(Interp *in, Frame *f, NodeId target, int *type) {
+    const AstNode *node = ast_at(AST, target);
+    Value *v;
+
+    switch (node->kind) {
+    case AST_NAME:
+        v = variable(in, f, target);
+        if (v)
+            *type = interp_decl_type(in, in->info[target]);
+        return v;
+    case AST_MEMBER: {
+        Object *obj = receiver(in, f, node->a);
+        NodeId decl;
+
+        if (!obj)
+            return NULL;
+        decl = hierarchy_member(&in->classes, obj->cls, node->v.sym);
+        if (!decl || ast_at(AST, decl)->kind != AST_FIELD) {
+            interp_error(in, node->line, "class '%.*s' has no field '%.*s'",
+                          NAME(in->classes.classes[obj->cls].name), NAME(node->v.sym));
+            return NULL;
+        }
+        *type = interp_decl_type(in, decl);
+        return field_of(in, obj, decl, node->line);
+    }
+    case AST_INDEX: {
+        const AstNode *name = ast_at(AST, node->a);
+        int64_t row = eval_index(in, f, node->b);
+        int64_t col = node->c ? eval_index(in, f, node->c) : 0;
+
+        v = variable(in, f, node->a);
+        if (!v)
+            return NULL;
+        if (v->kind != VAL_ARRAY) {
+            interp_error(in, node->line, "'%.*s' is not an array", NAME(name->v.sym));
+            return NULL;
+        }
+        *type = interp_decl_type(in, v->v.arr->decl);
+        return interp_element(in, v->v.arr, row, col, node->c ? 2 : 1, node->line);
+    }
+    default:
+        interp_error(in, node->line, "cannot assign to this expression");
+        return NULL;
+    }
+}
+
+// Storage of an AST_MEMBER in a method running on self, whose receiver is
+// a field
+Value *interp_member(Interp *in, Object *self, NodeId member, int *type) {
+    Frame f = { self, NULL };
+
+    return place(in, &f, member, type);
+}
+
+// Value converted for storing into a variable of the given type
+Value interp_convert(Interp *in, int type, Value v, uint32_t line) {
+    switch (type) {
+    case TYPE_INTEGER:
+        if (v.kind == VAL_FLOAT) {
+            v.kind = VAL_INT;
+            v.v.i = (int64_t)v.v.f;
+        }
+        break;
+    case TYPE_FLOAT:
+        if (v.kind == VAL_INT) {
+            v.kind = VAL_FLOAT;
+            v.v.f = (double)v.v.i;
+        }
+        break;
+    default:
+        return v;
+    }
+    if (v.kind != VAL_INT && v.kind != VAL_FLOAT)
+        interp_error(in, line, "cannot store a %s in a number", v.kind == VAL_STRING ? "string" : "reference");
+    return v;
+}
+
+// ---- expressions ----
+
+static int truth(Interp *in, Value v, uint32_t line) {
+    if (v.kind == VAL_INT)
+        return v.v.i != 0;
+    if (v.kind == VAL_FLOAT)
+        return v.v.f != 0;
+    interp_error(in, line, "condition is not a number");
+    return 0;
+}
+
+static Value arith(Interp *in, int op, Value l, Value r, uint32_t line) {
+    Value v = zero;
+
+    if ((l.kind != VAL_INT && l.kind != VAL_FLOAT) || (r.kind != VAL_INT && r.kind != VAL_FLOAT)) {
+        interp_error(in, line, "operands are not numbers");
+        return v;
+    }
+    if (l.kind == VAL_INT && r.kind == VAL_INT) {
+        // Unsigned arithmetic wraps where signed would overflow
+        uint64_t a = (uint64_t)l.v.i, b = (uint64_t)r.v.i;
+
+        switch (op) {
+        case PLUS: v.v.i = (int64_t)(a + b); break;
+        case MINUS: v.v.i = (int64_t)(a - b); break;
+        case MULT: v.v.i = (int64_t)(a * b); break;
+        case DIV:
+            if (r.v.i == 0)
+                interp_error(in, line, "division by zero");
+            else if (r.v.i == -1)
+                v.v.i = (int64_t)(0 - a);
+            else
+                v.v.i = l.v.i / r.v.i;
+            break;
+        case LT: v.v.i = l.v.i < r.v.i; break;
+        case GT: v.v.i = l.v.i > r.v.i; break;
+        case LE: v.v.i = l.v.i <= r.v.i; break;
+        case GE: v.v.i = l.v.i >= r.v.i; break;
+        case EQ: v.v.i = l.v.i == r.v.i; break;
+        case NE: v.v.i = l.v.i != r.v.i; break;
+        }
+        return v;
+    } else {
+        double a = l.kind == VAL_FLOAT ? l.v.f : (double)l.v.i;
+        double b = r.kind == VAL_FLOAT ? r.v.f : (double)r.v.i;
+
+        switch (op) {
+        case PLUS: v.v.f = a + b; break;
+        case MINUS: v.v.f = a - b; break;
+        case MULT: v.v.f = a * b; break;
+        case DIV: v.v.f = a / b; break;
+        case LT: v.v.i = a < b; return v;
+        case GT: v.v.i = a > b; return v;
+        case LE: v.v.i = a <= b; return v;
+        case GE: v.v.i = a >= b; return v;
+        case EQ: v.v.i = a == b; return v;
+        case NE: v.v.i = a != b; return v;
+        }
+        v.kind = VAL_FLOAT;
+        return v;
+    }
+}
+
+// Runs method on self. The arguments are at args, the top of the value
+// stack, where the tree interpreter extends them into the method's frame.
+Value interp_enter(Interp *in, Object *self, NodeId method, Value *args, uint32_t line) {
+    const AstNode *node = ast_at(AST, method);
+    VmCode *code = in->vm ? vm_code(in, method) : NULL;
+    uint32_t base = (uint32_t)(args - in->stack);
+    uint32_t size = in->info[method];
+    uint32_t saved = in->sp;
+    Frame frame = { self, args };
+    Value result = zero;
+    NodeId param;
+    uint32_t i;
+
+    if (in->depth == INTERP_MAX_CALLS || base + size > INTERP_STACK_VALUES) {
+        interp_error(in, line, "calls nest too deeply");
+        return result;
+    }
+    in->depth++;
+    if (code && vm_accepts(in, code, args)) {
+        result = vm_execute(in, code, self, args, line);
+    } else {
+        in->sp = base + size;
+        i = 0;
+        AST_FOREACH(AST, node->a, param) {
+            if (!interp_is_array(in, param))
+                args[i] = interp_convert(in, interp_decl_type(in, param), args[i], line);
+            else if (args[i].kind != VAL_ARRAY)
+                interp_error(in, line, "argument '%.*s' is not an array", NAME(ast_at(AST, param)->v.sym));
+            i++;
+        }
+        // Locals a skipped declaration leaves unset read as 0 on every call
+        for (; i < size; i++)
+            args[i] = zero;
+        if (!in->halted && exec_list(in, &frame, node->c) == FLOW_RETURN)
+            result = node->b ? interp_convert(in, interp_decl_type(in, method), in->ret, line) : in->ret;
+    }
+    in->depth--;
+    in->sp = saved;
+    return result;
+}
+
+// Method a call runs, found from the class of its receiver, which is
+// returned through receiver; 0 after reporting
+static NodeId target(Interp *in, Frame *f, const AstNode *node, Object **receiver_out) {
+    Object *self = f->self;
+    NodeId method = 0;
+
+    if (node->op == CALL_FUNCTION) {
+        if (self)
+            method = hierarchy_member(&in->classes, self->cls, node->v.sym);
+    } else if (node->op == CALL_METHOD) {
+        self = receiver(in, f, node->a);
+        if (!self)
+            return 0;
+        method = hierarchy_member(&in->classes, self->cls, node->v.sym);
+    } else {
+        const AstNode *cls = ast_at(AST, node->a);
+        uint32_t index = hierarchy_find(&in->classes, cls->v.sym);
+
+        if (index == CLASS_NONE) {
+            interp_error(in, node->line, "class '%.*s' is not declared", NAME(cls->v.sym));
+            return 0;
+        }
+        method = hierarchy_member(&in->classes, index, node->v.sym);
+        if (!self)
+            self = new_object(in, index);
+    }
+    if (!method || ast_at(AST, method)->kind != AST_METHOD) {
+        interp_error(in, node->line, "no method '%.*s'", NAME(node->v.sym));
+        return 0;
+    }
+    *receiver_out = self;
+    return method;
+}
+
+// For a call made by a method running on self whose receiver, if any, is
+// a field
+NodeId interp_target(Interp *in, Object *self, NodeId call, Object **receiver_out) {
+    Frame f = { self, NULL };
+
+    return target(in, &f, ast_at(AST, call), receiver_out);
+}
+
+// Arguments are evaluated onto the value stack, each claimed before the
+// next is evaluated so that calls among them go above it
+static Value call(Interp *in, Frame *f, const AstNode *node) {
+    Object *self;
+    NodeId method = target(in, f, node, &self);
+    uint32_t base = in->sp;
+    uint32_t nparams, nargs;
+    Value result;
+    NodeId arg;
+
+    if (!method)
+        return zero;
+    nparams = list_length(AST, ast_at(AST, method)->a);
+    nargs = list_length(AST, node->b);
+    if (nargs != nparams) {
+        interp_error(in, node->line, "'%.*s' takes %u arguments", NAME(ast_at(AST, method)->v.sym), nparams);
+        return zero;
+    }
+    if (base + nargs > INTERP_STACK_VALUES) {
+        interp_error(in, node->line, "calls nest too deeply");
+        return zero;
+    }
+    AST_FOREACH(AST, node->b, arg) {
+        Value v = eval(in, f, arg);
+        in->stack[in->sp++] = v;
+    }
+    result = interp_enter(in, self, method, in->stack + base, node->line);
+    in->sp = base;
+    return result;
+}
+
+static Value eval(Interp *in, Frame *f, NodeId expr) {
+    const AstNode *node = ast_at(AST, expr);
+    Value v = zero;
+    Value *p;
+    int type;
+
+    switch (node->kind) {
+    case AST_INT:
+        v.v.i = node->v.ival;
+        return v;
+    case AST_FLOAT:
+        v.kind = VAL_FLOAT;
+        v.v.f = node->v.fval;
+        return v;
+    case AST_STRING:
+        v.kind = VAL_STRING;
+        v.v.s = node->v.sym;
+        return v;
+    case AST_BINARY:
+        if (node->op == AND || node->op == OR) {
+            int left = truth(in, eval(in, f, node->a), node->line);
+            if (left == (node->op == OR)) {
+                v.v.i = left;
+                return v;
+            }
+            v.v.i = truth(in, eval(in, f, node->b), node->line);
+            return v;
+        }
+        // The left operand runs first, as in the other engines
+        v = eval(in, f, node->a);
+        return arith(in, node->op, v, eval(in, f, node->b), node->line);
+    case AST_NOT:
+        v.v.i = !truth(in, eval(in, f, node->a), node->line);
+        return v;
+    case AST_NAME:
+    case AST_MEMBER:
+    case AST_INDEX:
+        p = place(in, f, expr, &type);
+        return p ? *p : zero;
+    case AST_CALL:
+        return call(in, f, node);
+    default:
+        return v;
+    }
+}
+
+// ---- statements ----
+
+// Escapes other than \n, \t and \r stand for the character itself
+static void write_string(Interp *in, SymbolId sym) {
+    const char *s = intern_str(&in->ctx->symbol_table.strings, sym);
+    uint32_t len = intern_len(&in->ctx->symbol_table.strings, sym);
+    FILE *out = in->ctx->out;
+    uint32_t i;
+
+    for (i = 1; i + 1 < len; i++) {
+        char c = s[i];
+        if (c == '\\' && i + 2 < len) {
+            c = s[++i];
+            c = c == 'n' ? '\n' : c == 't' ? '\t' : c == 'r' ? '\r' : c;
+        }
+        putc(c, out);
+    }
+    putc('\n', out);
+}
+
+// Nothing is written once an error has stopped the run, so a write does
+// not print the dummy value its failed operand left
+void interp_write(Interp *in, Value v, uint32_t line) {
+    if (in->halted)
+        return;
+    switch (v.kind) {
+    case VAL_INT:
+        fprintf(in->ctx->out, "%lld\n", (long long)v.v.i);
+        break;
+    case VAL_FLOAT:
+        fprintf(in->ctx->out, "%g\n", v.v.f);
+        break;
+    case VAL_STRING:
+        write_string(in, v.v.s);
+        break;
+    default:
+        interp_error(in, line, "cannot write an object or array");
+        break;
+    }
+}
+
+// Next number of the input for a target of the given type; at its end,
+// or on anything that is not a number, 0
+Value interp_read(Interp *in, int type) {
+    Value v = zero;
+    long long i = 0;
+    double d = 0;
+
+    if (type == TYPE_FLOAT) {
+        if (fscanf(in->in, "%lf", &d) != 1)
+            d = 0;
+        v.kind = VAL_FLOAT;
+        v.v.f = d;
+    } else {
+        if (fscanf(in->in, "%lld", &i) != 1)
+            i = 0;
+        v.v.i = i;
+    }
+    return v;
+}
+
+static void read_into(Interp *in, Frame *f, NodeId target, uint32_t line) {
+    int type;
+    Value *p = place(in, f, target, &type);
+
+    if (!p)
+        return;
+    if (type == TYPE_FLOAT || type == TYPE_INTEGER)
+        *p = interp_read(in, type);
+    else
+        interp_error(in, line, "cannot read into an object");
+}
+
+static Flow exec(Interp *in, Frame *f, NodeId stmt) {
+    const AstNode *node = ast_at(AST, stmt);
+    Value *p;
+    Value v;
+    int type;
+    Flow flow;
+
+    in->steps++;
+    switch (node->kind) {
+    case AST_DECL:
+        type = interp_decl_type(in, stmt);
+        f->locals[in->info[stmt]] = node->b ? interp_convert(in, type, eval(in, f, node->b), node->line) : zero_of(type);
+        break;
+    case AST_BLOCK:
+        return exec_list(in, f, node->a);
+    case AST_ASSIGN:
+        v = eval(in, f, node->b);
+        p = place(in, f, node->a, &type);
+        if (p)
+            *p = interp_convert(in, type, v, node->line);
+        break;
+    case AST_IF:
+        if (truth(in, eval(in, f, node->a), node->line))
+            return exec(in, f, node->b);
+        if (node->c)
+            return exec(in, f, node->c);
+        break;
+    case AST_WHILE:
+        while (truth(in, eval(in, f, node->a), node->line) && !in->halted) {
+            flow = exec(in, f, node->b);
+            if (flow != FLOW_NEXT)
+                return flow;
+        }
+        break;
+    case AST_READ:
+        read_into(in, f, node->a, node->line);
+        break;
+    case AST_WRITE:
+        interp_write(in, eval(in, f, node->a), node->line);
+        break;
+    case AST_RETURN:
+        in->ret = node->a ? eval(in, f, node->a) : zero;
+        return in->halted ? FLOW_HALT : FLOW_RETURN;
+    default:
+        break;
+    }
+    return in->halted ? FLOW_HALT : FLOW_NEXT;
+}
+
+static Flow exec_list(Interp *in, Frame *f, NodeId list) {
+    NodeId id;
+    Flow flow;
+
+    AST_FOREACH(AST, list, id) {
+        flow = exec(in, f, id);
+        if (flow != FLOW_NEXT)
+            return flow;
+    }
+    return FLOW_NEXT;
+}
+
+// ---- entry ----
+
+static int run_method(Interp *in, uint32_t cls, NodeId method) {
+    if (ast_at(AST, method)->a) {
+        interp_error(in, ast_at(AST, method)->line, "entry method '%.*s' takes parameters",
+                      NAME(ast_at(AST, method)->v.sym));
+        return 1;
+    }
+    interp_enter(in, new_object(in, cls), method, in->stack + in->sp, ast_at(AST, method)->line);
+    return in->halted;
+}
+
+// Method named by "Class.method", or 0 after reporting
+static NodeId find_entry(Interp *in, const char *entry, uint32_t *cls) {
+    const InternPool *pool = &in->ctx->symbol_table.strings;
+    const char *dot = strchr(entry, '.');
+    uint32_t i;
+    NodeId method;
+
+    *cls = CLASS_NONE;
+    for (i = 0; dot && i < in->classes.count && *cls == CLASS_NONE; i++) {
+        SymbolId name = in->classes.classes[i].name;
+        if (intern_len(pool, name) == (size_t)(dot - entry) && memcmp(intern_str(pool, name), entry, (size_t)(dot - entry)) == 0)
+            *cls = i;
+    }
+    if (*cls == CLASS_NONE) {
+        fprintf(in->ctx->err, "Error: No class for entry '%s'\n", entry);
+        return 0;
+    }
+    AST_FOREACH(AST, ast_at(AST, in->classes.classes[*cls].decl)->b, method) {
+        const AstNode *node = ast_at(AST, method);
+        if (node->kind == AST_METHOD && intern_len(pool, node->v.sym) == strlen(dot + 1) &&
+            memcmp(intern_str(pool, node->v.sym), dot + 1, strlen(dot + 1)) == 0)
+            return method;
+    }
+    fprintf(in->ctx->err, "Error: No method for entry '%s'\n", entry);
+    return 0;
+}
+
+// A program of bare statements runs them. Otherwise entry names the
+// method to run on a new object of its class; without one, the first
+// class with a parameterless main runs it, and failing that every class
+// gets an object that runs each of its parameterless methods in order.
+static int run_program(Interp *in, const AstNode *program, const char *entry) {
+    uint32_t cls, i;
+    NodeId id;
+
+    if (program->b) {
+        Frame top = { NULL, in->stack };
+        in->sp = in->top_frame;
+        exec_list(in, &top, program->b);
+        return in->halted;
+    }
+    if (*entry) {
+        id = find_entry(in, entry, &cls);
+        return id ? run_method(in, cls, id) : 1;
+    }
+    for (i = 0; i < in->classes.count; i++) {
+        AST_FOREACH(AST, ast_at(AST, in->classes.classes[i].decl)->b, id) {
+            const AstNode *node = ast_at(AST, id);
+            const InternPool *pool = &in->ctx->symbol_table.strings;
+            if (node->kind == AST_METHOD && !node->a && intern_len(pool, node->v.sym) == 4 &&
+                memcmp(intern_str(pool, node->v.sym), "main", 4) == 0)
+                return run_method(in, i, id);
+        }
+    }
+    for (i = 0; i < in->classes.count; i++) {
+        Object *obj = new_object(in, i);
+
+        AST_FOREACH(AST, ast_at(AST, in->classes.classes[i].decl)->b, id) {
+            if (ast_at(AST, id)->kind == AST_METHOD && !ast_at(AST, id)->a) {
+                interp_enter(in, obj, id, in->stack + in->sp, ast_at(AST, id)->line);
+                if (in->halted)
+                    return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Builds the hierarchy and binds the names of a successful parse, then
+// folds its constant expressions unless --no-fold. The translation to C
+// (cgen.c) works from the same bindings.
+void interp_init(Interp *in, ParseContext *ctx) {
+    const AstNode *program = ast_at(&ctx->ast, ctx->root);
+
+    memset(in, 0, sizeof(*in));
+    in->ctx = ctx;
+    hierarchy_build(&in->classes, &ctx->ast, program->a);
+    in->layouts = xcalloc(in->classes.count, sizeof(ClassLayout));
+    in->info = xcalloc(ctx->ast.count, sizeof(uint32_t));
+    resolve_program(in, program);
+    if (ctx->fold) {
+        uint32_t removed = fold_program(in);
+        if (ctx->stats)
+            ctx->stats->folded += removed;
+    }
+}
+
+void interp_free(Interp *in) {
+    uint32_t i;
+
+    for (i = 0; i < in->classes.count; i++) {
+        free(in->layouts[i].slot_of);
+        free(in->layouts[i].fields);
+    }
+    free(in->layouts);
+    free(in->info);
+    arena_free(&in->heap);
+    hierarchy_free(&in->classes);
+}
+
+// Runs the program of a successful parse, with write going to ctx->out and
+// read taking stdin. Returns 0, or 1 after a runtime error.
+int interp_run(ParseContext *ctx, const char *entry) {
+    Interp state;
+    Interp *in = &state;
+    int status;
+
+    interp_init(in, ctx);
+    in->in = stdin;
+    in->vm = ctx->engine == ENGINE_VM || ctx->engine == ENGINE_JIT;
+    in->jit = ctx->engine == ENGINE_JIT;
+    in->stack = xcalloc(INTERP_STACK_VALUES, sizeof(Value));
+    if (in->vm)
+        vm_init(in);
+
+    status = run_program(in, ast_at(&ctx->ast, ctx->root), entry);
+    fflush(ctx->out);
+    if (ctx->stats) {
+        ctx->stats->steps += in->steps;
+        ctx->stats->ops += in->ops;
+        ctx->stats->jitted += in->jitted;
+    }
+
+    if (in->vm)
+        vm_free(in);
+    free(in->stack);
+    interp_free(in);
+    return status;
+}
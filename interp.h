@@ -0,0 +1,11 @@
+#ifndef INTERP_H
+#define INTERP_H
+
+#include "context.h"
+
+typedef enum { ENGINE_TREE, ENGINE_VM, ENGINE_JIT } Engine;
+
+// Entry for --run: "Class.method", or "" to pick one (see interp_run)
+int interp_run(ParseContext *ctx, const char *entry);
+
+#endif
@@ -0,0 +1,795 @@
+#include "jit.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Baseline JIT: the bytecode of a hot method (see vm.h) is translated
+// instruction by instruction into x86-64 templates in executable pages.
+// The machine code works on the same register frame as the VM, with the
+// most used integer and array locals kept in rbx, r12-r14 and the most
+// used float locals in xmm8-xmm13; floats use SSE2. So the two can hand
+// a running call back and forth at any instruction: entering loads the
+// locals from the frame, and leaving stores them back.
+//
+// Machine code leaves ("deoptimizes") whenever an instruction is off its
+// fast path: an index out of bounds, a row to grow, a missing field,
+// division by zero. The VM then runs that instruction itself, with the
+// usual errors, and promotes the method again at its next backward jump.
+// Calls, member access through other objects, read and write go through
+// the VM's own helper for them.
+
+#if defined(__x86_64__) && defined(__linux__)
+
+#include <sys/mman.h>
+
+typedef struct {
+    Interp *in;
+    VmCode *code;
+    Object *self;
+    const int32_t *slot_of;
+    Word *R;
+    Value result;
+} JitFrame;
+
+typedef int32_t (*JitFn)(JitFrame *f, const uint8_t *entry);
+
+typedef struct JitCode {
+    uint8_t *text;          // mapped read and execute
+    size_t size;
+    uint32_t *at;           // offset of each bytecode instruction in text
+} JitCode;
+
+enum { RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI, R8, R9, R10, R11, R12, R13, R14, R15 };
+enum { CC_AE = 3, CC_E = 4, CC_NE = 5, CC_A = 7, CC_S = 8, CC_P = 10, CC_NP = 11, CC_L = 12, CC_GE = 13,
+       CC_LE = 14, CC_G = 15 };
+
+#define FRAME RBP               // JitFrame *
+#define REGS R15                // the frame's registers
+#define NO_HOME (-1)
+
+static const int gpr_homes[] = { RBX, R12, R13, R14 };
+static const int xmm_homes[] = { 8, 9, 10, 11, 12, 13 };
+
+enum { FIX_PC, FIX_DEOPT, FIX_FAIL, FIX_EXIT };
+
+typedef struct {
+    uint32_t pos;           // of a rel32
+    uint32_t kind;
+    uint32_t pc;
+} Fixup;
+
+typedef struct {
+    const VmCode *code;
+    uint8_t *buf;
+    size_t len;
+    size_t capacity;
+    int8_t *gpr;            // home of each local, or NO_HOME
+    int8_t *xmm;
+    uint32_t *at;
+    Fixup *fixups;
+    uint32_t nfixups;
+    uint32_t fixups_capacity;
+} Asm;
+
+static void *grow(void *p, size_t size) {
+    p = realloc(p, size ? size : 1);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+// ---- encoding ----
+
+static void byte(Asm *a, int b) {
+    if (a->len == a->capacity) {
+        a->capacity = a->capacity ? a->capacity * 2 : 4096;
+        a->buf = grow(a->buf, a->capacity);
+    }
+    a->buf[a->len++] = (uint8_t)b;
+}
+
+static void u32(Asm *a, uint32_t v) {
+    int i;
+
+    for (i = 0; i < 4; i++)
+        byte(a, (int)(v >> (8 * i)) & 0xff);
+}
+
+static void u64(Asm *a, uint64_t v) {
+    u32(a, (uint32_t)v);
+    u32(a, (uint32_t)(v >> 32));
+}
+
+static void rex(Asm *a, int w, int reg, int rm) {
+    int r = 0x40 | w << 3 | (reg & 8) >> 1 | (rm & 8) >> 3;
+
+    if (r != 0x40)
+        byte(a, r);
+}
+
+static void opcode(Asm *a, uint32_t op) {
+    if (op > 0xff)
+        byte(a, (int)(op >> 8));
+    byte(a, (int)(op & 0xff));
+}
+
+// [prefix] [REX] op, with reg and a register operand
+static void rr(Asm *a, int prefix, int w, uint32_t op, int reg, int rm) {
+    if (prefix)
+        byte(a, prefix);
+    rex(a, w, reg, rm);
+    opcode(a, op);
+    byte(a, 0xc0 | (reg & 7) << 3 | (rm & 7));
+}
+
+// [prefix] [REX] op, with reg and the operand [base + disp32]
+static void rm(Asm *a, int prefix, int w, uint32_t op, int reg, int base, int32_t disp) {
+    if (prefix)
+        byte(a, prefix);
+    rex(a, w, reg, base);
+    opcode(a, op);
+    byte(a, 0x80 | (reg & 7) << 3 | (base & 7));
+    if ((base & 7) == RSP)
+        byte(a, 0x24);
+    u32(a, (uint32_t)disp);
+}
+
+static void mov_rr(Asm *a, int dst, int src) { rr(a, 0, 1, 0x8b, dst, src); }
+static void load(Asm *a, int dst, int base, int32_t disp) { rm(a, 0, 1, 0x8b, dst, base, disp); }
+static void load32(Asm *a, int dst, int base, int32_t disp) { rm(a, 0, 0, 0x8b, dst, base, disp); }
+static void store(Asm *a, int base, int32_t disp, int src) { rm(a, 0, 1, 0x89, src, base, disp); }
+static void alu(Asm *a, uint32_t op, int dst, int src) { rr(a, 0, 1, op, dst, src); }
+static void test(Asm *a, int r) { rr(a, 0, 1, 0x85, r, r); }
+static void setcc(Asm *a, int cc, int r) { rr(a, 0, 0, 0x0f90 | (uint32_t)cc, 0, r); }
+static void movapd(Asm *a, int dst, int src) { rr(a, 0x66, 0, 0x0f28, dst, src); }
+static void movq_xg(Asm *a, int x, int g) { rr(a, 0x66, 1, 0x0f6e, x, g); }
+static void movq_gx(Asm *a, int g, int x) { rr(a, 0x66, 1, 0x0f7e, x, g); }
+static void movsd_load(Asm *a, int x, int base, int32_t disp) { rm(a, 0xf2, 0, 0x0f10, x, base, disp); }
+static void movsd_store(Asm *a, int base, int32_t disp, int x) { rm(a, 0xf2, 0, 0x0f11, x, base, disp); }
+
+enum { ADD = 0x03, SUB = 0x2b, CMP = 0x3b, IMUL = 0x0faf };
+enum { ADDSD = 0x0f58, MULSD = 0x0f59, SUBSD = 0x0f5c, DIVSD = 0x0f5e };
+
+// add, sub or cmp (extension 0, 5, 7) of a sign-extended imm32
+static void alu_imm(Asm *a, int ext, int dst, int32_t v) {
+    rr(a, 0, 1, 0x81, ext, dst);
+    u32(a, (uint32_t)v);
+}
+
+static void mov_imm(Asm *a, int dst, int64_t v) {
+    if (v == (int32_t)v) {
+        rr(a, 0, 1, 0xc7, 0, dst);
+        u32(a, (uint32_t)v);
+    } else {
+        rex(a, 1, 0, dst);
+        byte(a, 0xb8 | (dst & 7));
+        u64(a, (uint64_t)v);
+    }
+}
+
+static void mov_eax(Asm *a, int32_t v) {
+    byte(a, 0xb8);
+    u32(a, (uint32_t)v);
+}
+
+static uint32_t jcc(Asm *a, int cc) {
+    byte(a, 0x0f);
+    byte(a, 0x80 | cc);
+    u32(a, 0);
+    return (uint32_t)a->len - 4;
+}
+
+static uint32_t jmp(Asm *a) {
+    byte(a, 0xe9);
+    u32(a, 0);
+    return (uint32_t)a->len - 4;
+}
+
+static void land(Asm *a, uint32_t pos, size_t target) {
+    uint32_t rel = (uint32_t)(target - (pos + 4));
+
+    memcpy(a->buf + pos, &rel, 4);
+}
+
+static void fixup(Asm *a, uint32_t pos, uint32_t kind, uint32_t pc) {
+    if (a->nfixups == a->fixups_capacity) {
+        a->fixups_capacity = a->fixups_capacity ? a->fixups_capacity * 2 : 64;
+        a->fixups = grow(a->fixups, a->fixups_capacity * sizeof(Fixup));
+    }
+    a->fixups[a->nfixups].pos = pos;
+    a->fixups[a->nfixups].kind = kind;
+    a->fixups[a->nfixups++].pc = pc;
+}
+
+static void push(Asm *a, int r) {
+    if (r & 8)
+        byte(a, 0x41);
+    byte(a, 0x50 | (r & 7));
+}
+
+static void pop(Asm *a, int r) {
+    if (r & 8)
+        byte(a, 0x41);
+    byte(a, 0x58 | (r & 7));
+}
+
+// ---- operands ----
+
+#define SLOT(r) ((int32_t)(r) * (int32_t)sizeof(Word))
+
+static int gpr_of(Asm *a, uint16_t r) {
+    return r < a->code->nlocals ? a->gpr[r] : NO_HOME;
+}
+
+static int xmm_of(Asm *a, uint16_t r) {
+    return r < a->code->nlocals ? a->xmm[r] : NO_HOME;
+}
+
+static int is_const(Asm *a, uint16_t r) {
+    return r >= a->code->nlocals && r < a->code->nlocals + a->code->nconsts;
+}
+
+static int64_t const_of(Asm *a, uint16_t r) {
+    return a->code->consts[r - a->code->nlocals].i;
+}
+
+static int is_imm32(Asm *a, uint16_t r) {
+    return is_const(a, r) && const_of(a, r) == (int32_t)const_of(a, r);
+}
+
+static void load_gpr(Asm *a, int dst, uint16_t r) {
+    if (gpr_of(a, r) != NO_HOME) {
+        if (gpr_of(a, r) != dst)
+            mov_rr(a, dst, gpr_of(a, r));
+    } else if (xmm_of(a, r) != NO_HOME) {
+        movq_gx(a, dst, xmm_of(a, r));
+    } else if (is_const(a, r)) {
+        mov_imm(a, dst, const_of(a, r));
+    } else {
+        load(a, dst, REGS, SLOT(r));
+    }
+}
+
+// Register holding r: its home, or scratch with r loaded
+static int use_gpr(Asm *a, uint16_t r, int scratch) {
+    if (gpr_of(a, r) != NO_HOME)
+        return gpr_of(a, r);
+    load_gpr(a, scratch, r);
+    return scratch;
+}
+
+static void store_gpr(Asm *a, uint16_t r, int src) {
+    if (gpr_of(a, r) != NO_HOME) {
+        if (gpr_of(a, r) != src)
+            mov_rr(a, gpr_of(a, r), src);
+    } else if (xmm_of(a, r) != NO_HOME) {
+        movq_xg(a, xmm_of(a, r), src);
+    } else {
+        store(a, REGS, SLOT(r), src);
+    }
+}
+
+// Constants are in the frame too, so floats load them from there
+static void load_xmm(Asm *a, int dst, uint16_t r) {
+    if (xmm_of(a, r) != NO_HOME) {
+        if (xmm_of(a, r) != dst)
+            movapd(a, dst, xmm_of(a, r));
+    } else if (gpr_of(a, r) != NO_HOME) {
+        movq_xg(a, dst, gpr_of(a, r));
+    } else {
+        movsd_load(a, dst, REGS, SLOT(r));
+    }
+}
+
+static int use_xmm(Asm *a, uint16_t r, int scratch) {
+    if (xmm_of(a, r) != NO_HOME)
+        return xmm_of(a, r);
+    load_xmm(a, scratch, r);
+    return scratch;
+}
+
+static void store_xmm(Asm *a, uint16_t r, int src) {
+    if (xmm_of(a, r) != NO_HOME) {
+        if (xmm_of(a, r) != src)
+            movapd(a, xmm_of(a, r), src);
+    } else if (gpr_of(a, r) != NO_HOME) {
+        movq_gx(a, gpr_of(a, r), src);
+    } else {
+        movsd_store(a, REGS, SLOT(r), src);
+    }
+}
+
+// Locals between their homes and the frame, on entry and exit and around
+// helper calls (xmm registers are not preserved by calls)
+static void reload(Asm *a) {
+    uint16_t r;
+
+    for (r = 0; r < a->code->nlocals; r++) {
+        if (a->gpr[r] != NO_HOME)
+            load(a, a->gpr[r], REGS, SLOT(r));
+        else if (a->xmm[r] != NO_HOME)
+            movsd_load(a, a->xmm[r], REGS, SLOT(r));
+    }
+}
+
+static void flush(Asm *a) {
+    uint16_t r;
+
+    for (r = 0; r < a->code->nlocals; r++) {
+        if (a->gpr[r] != NO_HOME)
+            store(a, REGS, SLOT(r), a->gpr[r]);
+        else if (a->xmm[r] != NO_HOME)
+            movsd_store(a, REGS, SLOT(r), a->xmm[r]);
+    }
+}
+
+// Which of a, b, c and k name registers
+enum { OPD_A = 1, OPD_B = 2, OPD_C = 4, OPD_K = 8 };
+
+static int operands(int op) {
+    switch (op) {
+    case VM_JMP: case VM_WRITES: case VM_RETV:
+        return 0;
+    case VM_JZ: case VM_JNZ: case VM_GETF: case VM_GETA: case VM_MGET: case VM_CALL:
+    case VM_READI: case VM_READF: case VM_WRITEI: case VM_WRITEF: case VM_RET:
+        return OPD_A;
+    case VM_SETFI: case VM_SETFF: case VM_MSET:
+        return OPD_B;
+    case VM_MOV: case VM_I2F: case VM_F2I:
+    case VM_BLTI: case VM_BGTI: case VM_BLEI: case VM_BGEI: case VM_BEQI: case VM_BNEI:
+        return OPD_A | OPD_B;
+    case VM_AGET2: case VM_ASET2I: case VM_ASET2F:
+        return OPD_A | OPD_B | OPD_C | OPD_K;
+    default:
+        return OPD_A | OPD_B | OPD_C;
+    }
+}
+
+// Homes go to the locals used by the most instructions
+static void assign_homes(Asm *a) {
+    const VmCode *code = a->code;
+    uint32_t *uses = grow(NULL, (code->nlocals ? code->nlocals : 1) * sizeof(uint32_t));
+    uint32_t i, ngpr = 0, nxmm = 0;
+
+    memset(uses, 0, code->nlocals * sizeof(uint32_t));
+    memset(a->gpr, NO_HOME, code->nlocals);
+    memset(a->xmm, NO_HOME, code->nlocals);
+    for (i = 0; i < code->len; i++) {
+        const Insn *insn = &code->insns[i];
+        int opd = operands(insn->op);
+
+        if ((opd & OPD_A) && insn->a < code->nlocals)
+            uses[insn->a]++;
+        if ((opd & OPD_B) && insn->b < code->nlocals)
+            uses[insn->b]++;
+        if ((opd & OPD_C) && insn->c < code->nlocals)
+            uses[insn->c]++;
+        if ((opd & OPD_K) && (uint32_t)insn->k < code->nlocals)
+            uses[insn->k]++;
+    }
+    for (;;) {
+        uint32_t best = 0, r;
+        int found = 0;
+
+        for (r = 0; r < code->nlocals; r++) {
+            int kind = code->local_kinds[r];
+            int room = kind == VAL_FLOAT ? nxmm < 6 : (kind == VAL_INT || kind == VAL_ARRAY) && ngpr < 4;
+            if (uses[r] && room && (!found || uses[r] > uses[best])) {
+                best = r;
+                found = 1;
+            }
+        }
+        if (!found)
+            break;
+        if (code->local_kinds[best] == VAL_FLOAT)
+            a->xmm[best] = (int8_t)xmm_homes[nxmm++];
+        else
+            a->gpr[best] = (int8_t)gpr_homes[ngpr++];
+        uses[best] = 0;
+    }
+    free(uses);
+}
+
+// ---- templates ----
+
+static void deopt(Asm *a, int cc, uint32_t pc) {
+    fixup(a, jcc(a, cc), FIX_DEOPT, pc);
+}
+
+static int32_t jit_slow(JitFrame *f, uint32_t pc) {
+    return vm_slow(f->in, f->code, f->self, f->R, f->code->insns + pc);
+}
+
+static void slow(Asm *a, uint32_t pc) {
+    flush(a);
+    mov_rr(a, RDI, FRAME);
+    byte(a, 0xbe);                  // mov esi, pc
+    u32(a, pc);
+    mov_imm(a, RAX, (int64_t)(intptr_t)jit_slow);
+    rr(a, 0, 0, 0xff, 2, RAX);      // call rax
+    reload(a);
+    rr(a, 0, 0, 0x85, RAX, RAX);    // test eax, eax
+    fixup(a, jcc(a, CC_E), FIX_FAIL, 0);
+}
+
+// rdx = &self->slots[slot_of[field]].kind
+static void field_slot(Asm *a, uint32_t field, uint32_t pc) {
+    load(a, RDX, FRAME, offsetof(JitFrame, slot_of));
+    rm(a, 0, 1, 0x63, RAX, RDX, (int32_t)(field * sizeof(int32_t)));   // movsxd rax, [rdx + 4 * field]
+    test(a, RAX);
+    deopt(a, CC_S, pc);
+    rr(a, 0, 1, 0xc1, 4, RAX);      // shl rax, 4: a Value is 16 bytes
+    byte(a, 4);
+    load(a, RDX, FRAME, offsetof(JitFrame, self));
+    alu(a, ADD, RDX, RAX);
+}
+
+#define SLOT_KIND ((int32_t)(offsetof(Object, slots) + offsetof(Value, kind)))
+#define SLOT_WORD ((int32_t)(offsetof(Object, slots) + offsetof(Value, v)))
+
+// rdx = &arr->data[rcx].v for the array in register arr, with rcx the
+// row and, for two dimensions, r8 the column
+static void element(Asm *a, int arr, int dims, uint32_t pc) {
+    load32(a, RAX, arr, offsetof(Array, rows));
+    alu(a, CMP, RCX, RAX);
+    deopt(a, CC_AE, pc);
+    if (dims == 2) {
+        load32(a, RAX, arr, offsetof(Array, cols));
+        alu(a, CMP, R8, RAX);
+        deopt(a, CC_AE, pc);
+        alu(a, IMUL, RCX, RAX);
+        alu(a, ADD, RCX, R8);
+    } else {
+        rm(a, 0, 0, 0x83, 7, arr, offsetof(Array, cols));   // cmp dword [arr + cols], 0
+        byte(a, 0);
+        deopt(a, CC_NE, pc);
+    }
+    load(a, RDX, arr, offsetof(Array, data));
+    rr(a, 0, 1, 0xc1, 4, RCX);      // shl rcx, 4
+    byte(a, 4);
+    alu(a, ADD, RDX, RCX);
+}
+
+static int int_cc(int op, int base) {
+    static const int cc[] = { CC_L, CC_G, CC_LE, CC_GE, CC_E, CC_NE };
+
+    return cc[op - base];
+}
+
+static void float_compare(Asm *a, const Insn *insn) {
+    int op = insn->op;
+    int l = use_xmm(a, insn->b, 0), r = use_xmm(a, insn->c, 1);
+
+    // unordered sets ZF, PF and CF: only != holds for a NaN
+    switch (op) {
+    case VM_LTF: rr(a, 0x66, 0, 0x0f2e, r, l); setcc(a, CC_A, RAX); break;
+    case VM_GTF: rr(a, 0x66, 0, 0x0f2e, l, r); setcc(a, CC_A, RAX); break;
+    case VM_LEF: rr(a, 0x66, 0, 0x0f2e, r, l); setcc(a, CC_AE, RAX); break;
+    case VM_GEF: rr(a, 0x66, 0, 0x0f2e, l, r); setcc(a, CC_AE, RAX); break;
+    case VM_EQF:
+        rr(a, 0x66, 0, 0x0f2e, l, r);
+        setcc(a, CC_E, RAX);
+        setcc(a, CC_NP, RCX);
+        rr(a, 0, 0, 0x20, RCX, RAX);    // and al, cl
+        break;
+    default:
+        rr(a, 0x66, 0, 0x0f2e, l, r);
+        setcc(a, CC_NE, RAX);
+        setcc(a, CC_P, RCX);
+        rr(a, 0, 0, 0x08, RCX, RAX);    // or al, cl
+        break;
+    }
+    rr(a, 0, 0, 0x0fb6, RAX, RAX);      // movzx eax, al
+    store_gpr(a, insn->a, RAX);
+}
+
+static void translate(Asm *a, uint32_t pc) {
+    const Insn *insn = &a->code->insns[pc];
+    uint32_t skip, done;
+    int arr, src, op = insn->op;
+
+    switch (op) {
+    case VM_MOV:
+        if (xmm_of(a, insn->a) != NO_HOME) {
+            load_xmm(a, xmm_of(a, insn->a), insn->b);
+        } else if (gpr_of(a, insn->a) != NO_HOME) {
+            load_gpr(a, gpr_of(a, insn->a), insn->b);
+        } else {
+            load_gpr(a, RAX, insn->b);
+            store_gpr(a, insn->a, RAX);
+        }
+        break;
+    case VM_I2F:
+        src = use_gpr(a, insn->b, RAX);
+        rr(a, 0xf2, 1, 0x0f2a, 0, src);         // cvtsi2sd xmm0, src
+        store_xmm(a, insn->a, 0);
+        break;
+    case VM_F2I:
+        src = use_xmm(a, insn->b, 0);
+        rr(a, 0xf2, 1, 0x0f2c, RAX, src);       // cvttsd2si rax, src
+        store_gpr(a, insn->a, RAX);
+        break;
+    case VM_ADDI:
+    case VM_SUBI:
+        // i = i + 1 on a local in a register is one instruction
+        if (insn->a == insn->b && gpr_of(a, insn->a) != NO_HOME && is_imm32(a, insn->c)) {
+            alu_imm(a, op == VM_ADDI ? 0 : 5, gpr_of(a, insn->a), (int32_t)const_of(a, insn->c));
+            break;
+        }
+        /* fall through */
+    case VM_MULI:
+        load_gpr(a, RAX, insn->b);
+        src = use_gpr(a, insn->c, RCX);
+        alu(a, op == VM_ADDI ? ADD : op == VM_SUBI ? SUB : IMUL, RAX, src);
+        store_gpr(a, insn->a, RAX);
+        break;
+    case VM_DIVI:
+        load_gpr(a, RCX, insn->c);
+        test(a, RCX);
+        deopt(a, CC_E, pc);
+        load_gpr(a, RAX, insn->b);
+        alu_imm(a, 7, RCX, -1);
+        skip = jcc(a, CC_NE);
+        rr(a, 0, 1, 0xf7, 3, RAX);              // neg rax: dividing by -1 wraps
+        done = jmp(a);
+        land(a, skip, a->len);
+        byte(a, 0x48);                          // cqo
+        byte(a, 0x99);
+        rr(a, 0, 1, 0xf7, 7, RCX);              // idiv rcx
+        land(a, done, a->len);
+        store_gpr(a, insn->a, RAX);
+        break;
+    case VM_ADDF:
+    case VM_SUBF:
+    case VM_MULF:
+    case VM_DIVF:
+        load_xmm(a, 0, insn->b);
+        src = use_xmm(a, insn->c, 1);
+        rr(a, 0xf2, 0, op == VM_ADDF ? ADDSD : op == VM_SUBF ? SUBSD : op == VM_MULF ? MULSD : DIVSD, 0, src);
+        store_xmm(a, insn->a, 0);
+        break;
+    case VM_LTI: case VM_GTI: case VM_LEI: case VM_GEI: case VM_EQI: case VM_NEI:
+        src = use_gpr(a, insn->b, RAX);
+        alu(a, CMP, src, use_gpr(a, insn->c, RCX));
+        setcc(a, int_cc(op, VM_LTI), RAX);
+        rr(a, 0, 0, 0x0fb6, RAX, RAX);          // movzx eax, al
+        store_gpr(a, insn->a, RAX);
+        break;
+    case VM_LTF: case VM_GTF: case VM_LEF: case VM_GEF: case VM_EQF: case VM_NEF:
+        float_compare(a, insn);
+        break;
+    case VM_JMP:
+        fixup(a, jmp(a), FIX_PC, (uint32_t)insn->k);
+        break;
+    case VM_JZ:
+    case VM_JNZ:
+        test(a, use_gpr(a, insn->a, RAX));
+        fixup(a, jcc(a, op == VM_JZ ? CC_E : CC_NE), FIX_PC, (uint32_t)insn->k);
+        break;
+    case VM_BLTI: case VM_BGTI: case VM_BLEI: case VM_BGEI: case VM_BEQI: case VM_BNEI:
+        src = use_gpr(a, insn->a, RAX);
+        if (is_imm32(a, insn->b))
+            alu_imm(a, 7, src, (int32_t)const_of(a, insn->b));
+        else
+            alu(a, CMP, src, use_gpr(a, insn->b, RCX));
+        fixup(a, jcc(a, int_cc(op, VM_BLTI)), FIX_PC, (uint32_t)insn->k);
+        break;
+    case VM_GETF:
+    case VM_GETA:
+        field_slot(a, (uint32_t)insn->k, pc);
+        if (op == VM_GETA) {
+            rm(a, 0, 0, 0x80, 7, RDX, SLOT_KIND);   // cmp byte [rdx + kind], VAL_ARRAY
+            byte(a, VAL_ARRAY);
+            deopt(a, CC_NE, pc);
+        }
+        load(a, RAX, RDX, SLOT_WORD);
+        store_gpr(a, insn->a, RAX);
+        break;
+    case VM_SETFI:
+    case VM_SETFF:
+        load_gpr(a, RCX, insn->b);
+        field_slot(a, (uint32_t)insn->k, pc);
+        rm(a, 0, 0, 0xc6, 0, RDX, SLOT_KIND);       // mov byte [rdx + kind], ...
+        byte(a, op == VM_SETFF ? VAL_FLOAT : VAL_INT);
+        store(a, RDX, SLOT_WORD, RCX);
+        break;
+    case VM_AGET:
+    case VM_AGET2:
+        arr = use_gpr(a, insn->b, R9);
+        load_gpr(a, RCX, insn->c);
+        if (op == VM_AGET2)
+            load_gpr(a, R8, (uint16_t)insn->k);
+        element(a, arr, op == VM_AGET2 ? 2 : 1, pc);
+        load(a, RAX, RDX, offsetof(Value, v));
+        store_gpr(a, insn->a, RAX);
+        break;
+    case VM_ASETI:
+    case VM_ASETF:
+        load_gpr(a, R10, insn->c);
+        arr = use_gpr(a, insn->a, R9);
+        load_gpr(a, RCX, insn->b);
+        element(a, arr, 1, pc);
+        store(a, RDX, offsetof(Value, v), R10);
+        break;
+    case VM_ASET2I:
+    case VM_ASET2F:
+        load_gpr(a, R10, (uint16_t)insn->k);
+        arr = use_gpr(a, insn->a, R9);
+        load_gpr(a, RCX, insn->b);
+        load_gpr(a, R8, insn->c);
+        element(a, arr, 2, pc);
+        store(a, RDX, offsetof(Value, v), R10);
+        break;
+    case VM_RET:
+    case VM_RETV:
+        if (op == VM_RET)
+            load_gpr(a, RAX, insn->a);
+        else
+            mov_imm(a, RAX, 0);
+        store(a, FRAME, offsetof(JitFrame, result) + offsetof(Value, v), RAX);
+        rm(a, 0, 0, 0xc6, 0, FRAME, offsetof(JitFrame, result) + offsetof(Value, kind));
+        byte(a, op == VM_RET ? insn->c : VAL_INT);
+        mov_eax(a, JIT_RETURN);
+        fixup(a, jmp(a), FIX_EXIT, 0);
+        break;
+    default:
+        slow(a, pc);
+        break;
+    }
+}
+
+static const int saved[] = { RBX, RBP, R12, R13, R14, R15 };
+
+// Entered as fn(frame, entry): saves the callee-saved registers, loads the
+// locals into their homes and jumps to the entry
+static void prologue(Asm *a) {
+    size_t i;
+
+    for (i = 0; i < sizeof(saved) / sizeof(saved[0]); i++)
+        push(a, saved[i]);
+    rr(a, 0, 1, 0x83, 5, RSP);      // sub rsp, 8: calls out need a 16-byte aligned stack
+    byte(a, 8);
+    mov_rr(a, FRAME, RDI);
+    load(a, REGS, FRAME, offsetof(JitFrame, R));
+    reload(a);
+    rr(a, 0, 0, 0xff, 4, RSI);      // jmp rsi
+}
+
+static JitCode *assemble(const VmCode *code) {
+    Asm state;
+    Asm *a = &state;
+    JitCode *jit = NULL;
+    uint32_t *stub_at, pc, i;
+    size_t deopt_common, fail, exit_at, size;
+    void *text;
+
+    memset(a, 0, sizeof(*a));
+    a->code = code;
+    a->gpr = grow(NULL, code->nlocals);
+    a->xmm = grow(NULL, code->nlocals);
+    a->at = grow(NULL, (code->len + 1) * sizeof(uint32_t));
+    stub_at = grow(NULL, code->len * sizeof(uint32_t));
+    memset(stub_at, 0xff, code->len * sizeof(uint32_t));
+    assign_homes(a);
+
+    prologue(a);
+    for (pc = 0; pc < code->len; pc++) {
+        a->at[pc] = (uint32_t)a->len;
+        translate(a, pc);
+    }
+    a->at[code->len] = (uint32_t)a->len;
+
+    // Leaving for the VM stores the locals back and returns the index
+    for (i = 0; i < a->nfixups; i++) {
+        uint32_t at = a->fixups[i].pc;
+        if (a->fixups[i].kind == FIX_DEOPT && at != UINT32_MAX && stub_at[at] == UINT32_MAX) {
+            stub_at[at] = (uint32_t)a->len;
+            mov_eax(a, (int32_t)at);
+            fixup(a, jmp(a), FIX_DEOPT, UINT32_MAX);
+        }
+    }
+    deopt_common = a->len;
+    flush(a);
+    fixup(a, jmp(a), FIX_EXIT, 0);
+    fail = a->len;
+    mov_eax(a, JIT_FAIL);
+    exit_at = a->len;
+    rr(a, 0, 1, 0x83, 0, RSP);      // add rsp, 8
+    byte(a, 8);
+    for (i = sizeof(saved) / sizeof(saved[0]); i-- > 0;)
+        pop(a, saved[i]);
+    byte(a, 0xc3);                  // ret
+
+    for (i = 0; i < a->nfixups; i++) {
+        const Fixup *f = &a->fixups[i];
+        switch (f->kind) {
+        case FIX_PC: land(a, f->pos, a->at[f->pc]); break;
+        case FIX_DEOPT: land(a, f->pos, f->pc == UINT32_MAX ? deopt_common : stub_at[f->pc]); break;
+        case FIX_FAIL: land(a, f->pos, fail); break;
+        default: land(a, f->pos, exit_at); break;
+        }
+    }
+
+    // Written while mapped writable, then switched to executable
+    size = (a->len + 4095) & ~(size_t)4095;
+    text = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (text != MAP_FAILED) {
+        memcpy(text, a->buf, a->len);
+        if (mprotect(text, size, PROT_READ | PROT_EXEC) == 0) {
+            jit = grow(NULL, sizeof(JitCode));
+            jit->text = text;
+            jit->size = size;
+            jit->at = a->at;
+            a->at = NULL;
+        } else {
+            munmap(text, size);
+        }
+    }
+    free(a->buf);
+    free(a->gpr);
+    free(a->xmm);
+    free(a->at);
+    free(a->fixups);
+    free(stub_at);
+    return jit;
+}
+
+int jit_ready(Interp *in, VmCode *code) {
+    if (code->jit_state == JIT_UNTRIED) {
+        code->jit = sizeof(Value) == 16 ? assemble(code) : NULL;
+        code->jit_state = code->jit ? JIT_READY : JIT_FAILED;
+        if (code->jit)
+            in->jitted++;
+    }
+    return code->jit_state == JIT_READY;
+}
+
+int32_t jit_enter(Interp *in, VmCode *code, Object *self, const int32_t *slot_of, Word *R, uint32_t pc,
+                  Value *result) {
+    JitFrame f;
+    JitFn fn = (JitFn)(uintptr_t)code->jit->text;
+    int32_t next;
+
+    f.in = in;
+    f.code = code;
+    f.self = self;
+    f.slot_of = slot_of;
+    f.R = R;
+    f.result = interp_zero;
+    next = fn(&f, code->jit->text + code->jit->at[pc]);
+    if (next == JIT_RETURN)
+        *result = f.result;
+    return next;
+}
+
+void jit_free(VmCode *code) {
+    if (code->jit) {
+        munmap(code->jit->text, code->jit->size);
+        free(code->jit->at);
+        free(code->jit);
+    }
+}
+
+#else
+
+// Elsewhere every method stays on the VM
+int jit_ready(Interp *in, VmCode *code) {
+    (void)in;
+    code->jit_state = JIT_FAILED;
+    return 0;
+}
+
+int32_t jit_enter(Interp *in, VmCode *code, Object *self, const int32_t *slot_of, Word *R, uint32_t pc,
+                  Value *result) {
+    (void)in; (void)code; (void)self; (void)slot_of; (void)R; (void)pc; (void)result;
+    return JIT_FAIL;
+}
+
+void jit_free(VmCode *code) {
+    (void)code;
+}
+
+#endif
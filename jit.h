@@ -0,0 +1,28 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <stdint.h>
+#include "vm.h"
+
+#define JIT_HOT_CALLS 100          // calls before a method is promoted
+#define JIT_HOT_LOOPS 1000         // backward jumps before it is promoted, entering at the loop head
+
+enum { JIT_UNTRIED, JIT_READY, JIT_FAILED };
+
+// What machine code ended with, besides a bytecode index where the VM
+// takes over
+#define JIT_RETURN (-1)
+#define JIT_FAIL (-2)              // a runtime error halted the run
+
+// Compiles the method's bytecode on first use; 0 if it stays on the VM
+// (no x86-64 Linux, or pages cannot be mapped executable)
+int jit_ready(Interp *in, VmCode *code);
+
+// Runs the machine code of a VM frame from bytecode index pc. Returns
+// JIT_RETURN with the result, JIT_FAIL, or the index to resume at.
+int32_t jit_enter(Interp *in, VmCode *code, Object *self, const int32_t *slot_of, Word *R, uint32_t pc,
+                  Value *result);
+
+void jit_free(VmCode *code);
+
+#endif
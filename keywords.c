@@ -0,0 +1,81 @@
+#include "keywords.h"
+#include <string.h>
+#include "parser.tab.h"
+
+#define KEYWORD_MIN_LEN 2
+#define KEYWORD_MAX_LEN 9
+#define KEYWORD_SLOTS 32
+
+// Perfect hash in the style of gperf: slot = (len + asso[s[0]] + asso[s[1]]) % 32.
+// The values were found by a search so that every keyword gets its own slot;
+// adding a keyword means searching again and reordering the table below.
+static const unsigned char asso[256] = {
+    ['a'] = 18, ['c'] = 0,  ['e'] = 5,  ['f'] = 23, ['h'] = 10, ['i'] = 20,
+    ['l'] = 16, ['m'] = 6,  ['n'] = 27, ['o'] = 12, ['p'] = 27, ['r'] = 25,
+    ['s'] = 26, ['t'] = 1,  ['u'] = 19, ['v'] = 14, ['w'] = 11
+};
+
+static const Keyword table[KEYWORD_SLOTS] = {
+    [1]  = { "local",     "LOCAL",      LOCAL },
+    [2]  = { "read",      "READ",       READ },
+    [3]  = { "implement", "IMPLEMENT",  IMPLEMENT },
+    [4]  = { "return",    "RETURN",     RETURN },
+    [7]  = { "or",        "OR",         OR },
+    [9]  = { "write",     "WRITE",      WRITE },
+    [10] = { "not",       "NOT",        NOT },
+    [12] = { "float",     "FLOAT_KW",   FLOAT_KW },
+    [13] = { "if",        "IF",         IF },
+    [14] = { "func",      "FUNC",       FUNC },
+    [15] = { "then",      "THEN",       THEN },
+    [16] = { "and",       "AND",        AND },
+    [17] = { "isa",       "ISA",        ISA },
+    [20] = { "public",    "PUBLIC",     PUBLIC },
+    [21] = { "class",     "CLASS",      CLASS },
+    [22] = { "integer",   "INTEGER_KW", INTEGER_KW },
+    [25] = { "else",      "ELSE",       ELSE },
+    [26] = { "while",     "WHILE",      WHILE },
+    [27] = { "private",   "PRIVATE",    PRIVATE },
+    [28] = { "attribute", "ATTRIBUTE",  ATTRIBUTE },
+    [30] = { "void",      "VOID",       VOID }
+};
+
+const TokenType token_types[] = {
+    { "IF", IF }, { "ELSE", ELSE }, { "WHILE", WHILE }, { "THEN", THEN },
+    { "READ", READ }, { "WRITE", WRITE }, { "RETURN", RETURN },
+    { "INTEGER_KW", INTEGER_KW }, { "FLOAT_KW", FLOAT_KW }, { "VOID", VOID },
+    { "EQ", EQ }, { "ASSIGN", ASSIGN }, { "EQUALS", EQUALS }, { "LE", LE },
+    { "GE", GE }, { "LT", LT }, { "GT", GT }, { "NE", NE }, { "PLUS", PLUS },
+    { "MINUS", MINUS }, { "MULT", MULT }, { "DIV", DIV },
+    { "AND", AND }, { "OR", OR }, { "NOT", NOT },
+    { "LPAREN", LPAREN }, { "RPAREN", RPAREN }, { "LBRACE", LBRACE },
+    { "RBRACE", RBRACE }, { "LBRACKET", LBRACKET }, { "RBRACKET", RBRACKET },
+    { "SEMI", SEMI }, { "COMMA", COMMA }, { "DOT", DOT }, { "SCOPE", SCOPE },
+    { "COLON", COLON },
+    { "CLASS", CLASS }, { "FUNC", FUNC }, { "IMPLEMENT", IMPLEMENT },
+    { "ISA", ISA }, { "PRIVATE", PRIVATE }, { "PUBLIC", PUBLIC },
+    { "LOCAL", LOCAL }, { "ATTRIBUTE", ATTRIBUTE },
+    { "ID", ID }, { "INT", INT }, { "FLOAT", FLOAT }, { "STRING", STRING },
+    { "ERROR", ERROR }
+};
+
+const int token_type_count = sizeof(token_types) / sizeof(token_types[0]);
+
+// Must run on an empty pool
+void token_types_intern(InternPool *pool) {
+    int i;
+
+    for (i = 0; i < token_type_count; i++)
+        intern(pool, token_types[i].name, strlen(token_types[i].name));
+}
+
+// Returns the keyword spelled by s[0..len), or NULL for an identifier
+const Keyword *keyword_lookup(const char *s, size_t len) {
+    const Keyword *kw;
+
+    if (len < KEYWORD_MIN_LEN || len > KEYWORD_MAX_LEN)
+        return NULL;
+    kw = &table[(len + asso[(unsigned char)s[0]] + asso[(unsigned char)s[1]]) % KEYWORD_SLOTS];
+    if (kw->name && kw->name[0] == s[0] && strncmp(kw->name, s, len) == 0 && kw->name[len] == '\0')
+        return kw;
+    return NULL;
+}
@@ -0,0 +1,27 @@
+#ifndef KEYWORDS_H
+#define KEYWORDS_H
+
+#include <stddef.h>
+#include "intern.h"
+
+typedef struct {
+    const char *name;
+    const char *type;   // token type name shown in the symbol table
+    int token;          // bison token code
+} Keyword;
+
+typedef struct {
+    const char *name;
+    int token;
+} TokenType;
+
+// Every token type name the scanner reports. token_types_intern puts them
+// first into a pool, so in every token store a type's SymbolId is its
+// index here and the token code is one load away.
+extern const TokenType token_types[];
+extern const int token_type_count;
+
+const Keyword *keyword_lookup(const char *s, size_t len);
+void token_types_intern(InternPool *pool);
+
+#endif
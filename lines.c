@@ -0,0 +1,74 @@
+#include "lines.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LINE_TRIM_MIN 1024      // line starts kept before trimming pays off
+
+// Appends the next len bytes of the source; memchr does the vector search
+void line_index_scan(LineIndex *idx, const char *buf, size_t len) {
+    const char *p = buf;
+    const char *end = buf + len;
+
+    while ((p = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+        p++;
+        if (idx->count == idx->capacity) {
+            idx->capacity = idx->capacity ? idx->capacity * 2 : 1024;
+            idx->starts = realloc(idx->starts, idx->capacity * sizeof(uint64_t));
+            if (!idx->starts) {
+                fprintf(stderr, "Error: Out of memory\n");
+                exit(1);
+            }
+        }
+        idx->starts[idx->count++] = idx->scanned + (uint64_t)(p - buf);
+    }
+    idx->scanned += len;
+}
+
+// Line and column (both from 1) of a byte offset. With a hint, lookups in
+// increasing offset order walk forward from the previous answer instead of
+// searching; hint may be NULL.
+void line_index_find(const LineIndex *idx, size_t *hint, uint64_t offset, int *line, int *column) {
+    size_t lo = 0, hi = idx->count;
+    size_t n;
+
+    if (hint && *hint <= idx->count && (*hint == 0 || idx->starts[*hint - 1] <= offset)) {
+        n = *hint;
+        while (n < idx->count && idx->starts[n] <= offset)
+            n++;
+        *hint = n;
+    } else {
+        // Number of line starts at or before offset
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (idx->starts[mid] <= offset)
+                lo = mid + 1;
+            else
+                hi = mid;
+        }
+        n = lo;
+        if (hint)
+            *hint = n;
+    }
+    *line = (int)(idx->dropped + n) + 1;
+    *column = (int)(offset - (n ? idx->starts[n - 1] : 0)) + 1;
+}
+
+// The start of the current line stays, so later lookups still find their
+// column. Waiting until half the entries can go keeps the moves linear.
+void line_index_trim(LineIndex *idx, size_t *hint) {
+    size_t n = *hint;
+
+    if (n < LINE_TRIM_MIN || n < idx->count / 2)
+        return;
+    n--;
+    memmove(idx->starts, idx->starts + n, (idx->count - n) * sizeof(uint64_t));
+    idx->count -= n;
+    idx->dropped += n;
+    *hint -= n;
+}
+
+void line_index_free(LineIndex *idx) {
+    free(idx->starts);
+    memset(idx, 0, sizeof(*idx));
+}
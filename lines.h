@@ -0,0 +1,25 @@
+#ifndef LINES_H
+#define LINES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Offsets of line starts, so a byte offset becomes (line, column) only
+// when a report needs it. A zero-initialized LineIndex is ready to use;
+// line 1 starts at offset 0 and is not stored.
+typedef struct {
+    uint64_t *starts;   // starts[i] is the offset of line dropped + i + 2
+    size_t count;
+    size_t capacity;
+    uint64_t scanned;   // bytes indexed so far
+    size_t dropped;     // line starts line_index_trim has let go of
+} LineIndex;
+
+void line_index_scan(LineIndex *idx, const char *buf, size_t len);
+void line_index_find(const LineIndex *idx, size_t *hint, uint64_t offset, int *line, int *column);
+// Lets go of the line starts before the line of the last lookup made with
+// hint, for a caller whose lookups never go back (--stream)
+void line_index_trim(LineIndex *idx, size_t *hint);
+void line_index_free(LineIndex *idx);
+
+#endif
@@ -0,0 +1,320 @@
+#include "parlex.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "keywords.h"
+#include "parser.tab.h"
+#include "pool.h"
+
+// Parallel lexing of one large file.
+//
+// The mapped file is cut into chunks at line starts, and every chunk gets
+// its own scanner and string pool on the worker pool. A chunk may start
+// inside a comment or string, so its first tokens can be wrong; each chunk
+// therefore lexes PARLEX_OVERLAP bytes into the next one. The scanner has
+// no state between tokens other than the offset, so once two chunks report
+// a token at the same offset they agree from there on: that offset is where
+// the earlier chunk hands over. If no such offset turns up, the next chunk
+// is lexed again from the earlier chunk's last token.
+//
+// The parser then replays the stitched token stream. Replay interns each
+// lexeme into the file's pool in token order, so symbol ids, the symbol
+// table and the parse match a sequential run exactly.
+
+int scanner_lex(YYSTYPE *lval, void *scanner);
+
+typedef struct {
+    ParseContext ctx;
+    ChunkInput input;
+    int open;
+    int at_eof;             // the scanner reached the end of the file
+    uint64_t start;         // this chunk's part of the file is [start, end)
+    uint64_t end;
+    uint64_t stop;          // lex until a token starts at or after this
+    LineIndex lines;        // line starts in [start, end)
+    SymbolId *remap;        // chunk symbol -> file symbol + 1, 0 if not yet seen
+} Chunk;
+
+// Replay tokens and unknown characters of chunk with offsets in [from, until)
+typedef struct {
+    Chunk *chunk;
+    uint64_t from;
+    uint64_t until;
+} Segment;
+
+typedef struct {
+    TokenChunk *block;
+    int index;
+} Cursor;
+
+typedef struct ParallelLex {
+    Chunk *chunks;
+    size_t nchunks;
+    Segment *segments;
+    size_t nsegments;
+    size_t segment;         // replay position
+    Cursor cursor;
+    size_t unknown;
+} ParallelLex;
+
+static void *xcalloc(size_t n, size_t size) {
+    void *p = calloc(n ? n : 1, size);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+void parlex_defer_unknown(ChunkInput *in, uint64_t offset) {
+    if (in->unknown_count == in->unknown_capacity) {
+        in->unknown_capacity = in->unknown_capacity ? in->unknown_capacity * 2 : 16;
+        in->unknown = realloc(in->unknown, in->unknown_capacity * sizeof(uint64_t));
+        if (!in->unknown) {
+            fprintf(stderr, "Error: Out of memory\n");
+            exit(1);
+        }
+    }
+    in->unknown[in->unknown_count++] = offset;
+}
+
+static int cursor_done(const Cursor *cur) {
+    return !cur->block || cur->index >= cur->block->count;
+}
+
+static uint64_t cursor_offset(const Cursor *cur) {
+    return token_offset(cur->block, &cur->block->tokens[cur->index]);
+}
+
+static void cursor_next(Cursor *cur) {
+    if (++cur->index >= cur->block->count && cur->block->next) {
+        cur->block = cur->block->next;
+        cur->index = 0;
+    }
+}
+
+// First token of ts at or after offset
+static Cursor cursor_seek(const TokenStore *ts, uint64_t offset) {
+    Cursor cur = { ts->head, 0 };
+
+    while (cur.block && cur.block->next && cur.block->next->base <= offset)
+        cur.block = cur.block->next;
+    while (!cursor_done(&cur) && cursor_offset(&cur) < offset)
+        cursor_next(&cur);
+    return cur;
+}
+
+static void lex_chunk(Chunk *c, uint64_t from) {
+    YYSTYPE lval;
+
+    if (context_open_chunk(&c->ctx, &c->input, from) != 0) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    c->open = 1;
+    c->at_eof = 0;
+    for (;;) {
+        if (scanner_lex(&lval, c->ctx.scanner) == 0) {
+            c->at_eof = 1;
+            break;
+        }
+        if (c->ctx.token_offset >= c->stop)
+            break;
+    }
+}
+
+static void close_chunk(Chunk *c) {
+    if (c->open)
+        context_close(&c->ctx);
+    c->open = 0;
+}
+
+// Pool task: index the chunk's newlines and lex it
+static void lex_task(void *arg, size_t index) {
+    Chunk *c = &((ParallelLex *)arg)->chunks[index];
+
+    c->lines.scanned = c->start;
+    line_index_scan(&c->lines, c->input.source + c->start, (size_t)(c->end - c->start));
+    lex_chunk(c, c->start);
+}
+
+// Decide which chunk supplies each stretch of the token stream
+static void plan_segments(ParallelLex *px) {
+    Chunk *c = &px->chunks[0];
+    uint64_t from = 0;
+    size_t n;
+
+    px->segments = xcalloc(px->nchunks, sizeof(Segment));
+    for (n = 1; n < px->nchunks && !c->at_eof; n++) {
+        Chunk *next = &px->chunks[n];
+        Cursor a = cursor_seek(&c->ctx.symbol_table, from > next->start ? from : next->start);
+        Cursor b = cursor_seek(&next->ctx.symbol_table, next->start);
+        uint64_t sync = 0;
+        int found = 0;
+
+        while (!found && !cursor_done(&a) && !cursor_done(&b)) {
+            uint64_t oa = cursor_offset(&a), ob = cursor_offset(&b);
+            if (oa == ob) {
+                sync = oa;
+                found = 1;
+            } else if (oa < ob) {
+                cursor_next(&a);
+            } else {
+                cursor_next(&b);
+            }
+        }
+        if (!found) {
+            // No common token within the overlap: start next over from the
+            // last token c is sure of
+            TokenChunk *tail = c->ctx.symbol_table.tail;
+            sync = token_offset(tail, &tail->tokens[tail->count - 1]);
+            close_chunk(next);
+            next->input.unknown_count = 0;
+            lex_chunk(next, sync);
+        }
+        px->segments[px->nsegments++] = (Segment){ c, from, sync };
+        c = next;
+        from = sync;
+    }
+    px->segments[px->nsegments++] = (Segment){ c, from, UINT64_MAX };
+}
+
+static void start_segment(ParallelLex *px) {
+    Segment *seg = &px->segments[px->segment];
+    ChunkInput *in = &seg->chunk->input;
+
+    px->cursor = cursor_seek(&seg->chunk->ctx.symbol_table, seg->from);
+    px->unknown = 0;
+    while (px->unknown < in->unknown_count && in->unknown[px->unknown] < seg->from)
+        px->unknown++;
+}
+
+int context_open_parallel(ParseContext *ctx, const char *path, int nthreads) {
+    ParallelLex *px;
+    uint64_t size;
+    size_t n, nlines;
+
+    memset(ctx, 0, sizeof(*ctx));
+    if (source_map_open(&ctx->map, path) != 0)
+        return -1;
+    size = ctx->map.size;
+    if (nthreads < 2 || size < 2 * (uint64_t)PARLEX_MIN_CHUNK) {
+        source_map_close(&ctx->map);
+        return -1;
+    }
+    ctx->path = path;
+    ctx->out = stdout;
+    ctx->err = stderr;
+    ctx->symbol_table.strings.borrow = 1;
+    token_types_intern(&ctx->symbol_table.strings);
+
+    // Several chunks per thread keep the pool busy when chunks differ in cost
+    px = xcalloc(1, sizeof(ParallelLex));
+    px->nchunks = (size_t)nthreads * 4;
+    if (px->nchunks > size / PARLEX_MIN_CHUNK)
+        px->nchunks = (size_t)(size / PARLEX_MIN_CHUNK);
+    px->chunks = xcalloc(px->nchunks, sizeof(Chunk));
+    for (n = 0; n < px->nchunks; n++) {
+        Chunk *c = &px->chunks[n];
+        uint64_t end = size * (n + 1) / px->nchunks;
+        const char *nl;
+
+        // Cut just after a newline, where a token is most likely to start
+        if (n + 1 < px->nchunks) {
+            nl = memchr(ctx->map.base + end, '\n', (size_t)(size - end));
+            end = nl ? (uint64_t)(nl - ctx->map.base) + 1 : size;
+        }
+        c->start = n ? px->chunks[n - 1].end : 0;
+        c->end = end > c->start ? end : c->start;
+        c->stop = c->end + PARLEX_OVERLAP;
+        c->input.source = ctx->map.base;
+        c->input.end = ctx->map.base + size;
+    }
+    pool_run(nthreads, px->nchunks, lex_task, px);
+
+    nlines = 0;
+    for (n = 0; n < px->nchunks; n++)
+        nlines += px->chunks[n].lines.count;
+    ctx->lines.starts = xcalloc(nlines, sizeof(uint64_t));
+    ctx->lines.capacity = nlines;
+    for (n = 0; n < px->nchunks; n++) {
+        LineIndex *part = &px->chunks[n].lines;
+        if (part->count)
+            memcpy(ctx->lines.starts + ctx->lines.count, part->starts, part->count * sizeof(uint64_t));
+        ctx->lines.count += part->count;
+        line_index_free(part);
+    }
+    ctx->lines.scanned = size;
+
+    plan_segments(px);
+    start_segment(px);
+    ctx->replay = px;
+    return 0;
+}
+
+// Next token for the parser, in place of scanner_lex
+int parlex_next(ParseContext *ctx) {
+    ParallelLex *px = ctx->replay;
+
+    while (px->segment < px->nsegments) {
+        Segment *seg = &px->segments[px->segment];
+        Chunk *c = seg->chunk;
+        ChunkInput *in = &c->input;
+        uint64_t tok = UINT64_MAX, unknown = UINT64_MAX;
+
+        if (!cursor_done(&px->cursor) && cursor_offset(&px->cursor) < seg->until)
+            tok = cursor_offset(&px->cursor);
+        if (px->unknown < in->unknown_count && in->unknown[px->unknown] < seg->until)
+            unknown = in->unknown[px->unknown];
+
+        if (unknown < tok) {
+            px->unknown++;
+            ctx->token_offset = unknown;
+            ctx->offset = unknown + 1;
+            report_unknown_char(ctx, unknown, ctx->map.base[unknown]);
+            return ERROR;
+        }
+        if (tok != UINT64_MAX) {
+            const Token *t = &px->cursor.block->tokens[px->cursor.index];
+            const InternPool *strings = &c->ctx.symbol_table.strings;
+            SymbolId sym;
+
+            if (!c->remap)
+                c->remap = xcalloc(strings->count, sizeof(SymbolId));
+            if (!c->remap[t->lexeme])
+                c->remap[t->lexeme] = intern(&ctx->symbol_table.strings, intern_str(strings, t->lexeme),
+                                             intern_len(strings, t->lexeme)) + 1;
+            sym = c->remap[t->lexeme] - 1;
+            // Type names were interned first everywhere, so their ids agree
+            token_store_push(&ctx->symbol_table, sym, t->token_type, tok);
+            ctx->token = sym;
+            ctx->token_offset = tok;
+            ctx->offset = tok + intern_len(strings, t->lexeme);
+            cursor_next(&px->cursor);
+            return token_types[t->token_type].token;
+        }
+
+        // Segment finished; its chunk is not needed again
+        free(c->remap);
+        c->remap = NULL;
+        close_chunk(c);
+        if (++px->segment < px->nsegments)
+            start_segment(px);
+    }
+    ctx->offset = ctx->map.size;
+    return 0;
+}
+
+void parlex_free(ParallelLex *px) {
+    size_t n;
+
+    for (n = 0; n < px->nchunks; n++) {
+        close_chunk(&px->chunks[n]);
+        free(px->chunks[n].remap);
+        free(px->chunks[n].input.unknown);
+        line_index_free(&px->chunks[n].lines);
+    }
+    free(px->chunks);
+    free(px->segments);
+    free(px);
+}
@@ -0,0 +1,14 @@
+#ifndef PARLEX_H
+#define PARLEX_H
+
+#include "context.h"
+
+#define PARLEX_MIN_CHUNK (1 << 20)  // smaller files are lexed on one thread
+#define PARLEX_OVERLAP (64 << 10)   // how far a chunk lexes into the next one
+
+int context_open_parallel(ParseContext *ctx, const char *path, int nthreads);
+int parlex_next(ParseContext *ctx);
+void parlex_defer_unknown(ChunkInput *in, uint64_t offset);
+void parlex_free(struct ParallelLex *px);
+
+#endif
@@ -1,124 +0,0 @@
-/* A Bison parser, made by GNU Bison 3.8.2.  */
-
-/* Bison interface for Yacc-like parsers in C
-
-   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
-   Inc.
-
-   This program is free software: you can redistribute it and/or modify
-   it under the terms of the GNU General Public License as published by
-   the Free Software Foundation, either version 3 of the License, or
-   (at your option) any later version.
-
-   This program is distributed in the hope that it will be useful,
-   but WITHOUT ANY WARRANTY; without even the implied warranty of
-   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
-   GNU General Public License for more details.
-
-   You should have received a copy of the GNU General Public License
-   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
-
-/* As a special exception, you may create a larger work that contains
-   part or all of the Bison parser skeleton and distribute that work
-   under terms of your choice, so long as that work isn't itself a
-   parser generator using the skeleton or a modified version thereof
-   as a parser skeleton.  Alternatively, if you modify or redistribute
-   the parser skeleton itself, you may (at your option) remove this
-   special exception, which will cause the skeleton and the resulting
-   Bison output files to be licensed under the GNU General Public
-   License without this special exception.
-
-   This special exception was added by the Free Software Foundation in
-   version 2.2 of Bison.  */
-
-/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
-   especially those whose name start with YY_ or yy_.  They are
-   private implementation details that can be changed or removed.  */
-
-#ifndef YY_YY_PARSER_TAB_H_INCLUDED
-# define YY_YY_PARSER_TAB_H_INCLUDED
-/* Debug traces.  */
-#ifndef YYDEBUG
-# define YYDEBUG 0
-#endif
-#if YYDEBUG
-extern int yydebug;
-#endif
-
-/* Token kinds.  */
-#ifndef YYTOKENTYPE
-# define YYTOKENTYPE
-  enum yytokentype
-  {
-    YYEMPTY = -2,
-    YYEOF = 0,                     /* "end of file"  */
-    YYerror = 256,                 /* error  */
-    YYUNDEF = 257,                 /* "invalid token"  */
-    IF = 258,                      /* IF  */
-    ELSE = 259,                    /* ELSE  */
-    WHILE = 260,                   /* WHILE  */
-    THEN = 261,                    /* THEN  */
-    READ = 262,                    /* READ  */
-    WRITE = 263,                   /* WRITE  */
-    RETURN = 264,                  /* RETURN  */
-    INTEGER_KW = 265,              /* INTEGER_KW  */
-    FLOAT_KW = 266,                /* FLOAT_KW  */
-    VOID = 267,                    /* VOID  */
-    EQ = 268,                      /* EQ  */
-    ASSIGN = 269,                  /* ASSIGN  */
-    EQUALS = 270,                  /* EQUALS  */
-    LE = 271,                      /* LE  */
-    GE = 272,                      /* GE  */
-    LT = 273,                      /* LT  */
-    GT = 274,                      /* GT  */
-    NE = 275,                      /* NE  */
-    PLUS = 276,                    /* PLUS  */
-    MINUS = 277,                   /* MINUS  */
-    MULT = 278,                    /* MULT  */
-    DIV = 279,                     /* DIV  */
-    AND = 280,                     /* AND  */
-    OR = 281,                      /* OR  */
-    NOT = 282,                     /* NOT  */
-    LPAREN = 283,                  /* LPAREN  */
-    RPAREN = 284,                  /* RPAREN  */
-    LBRACE = 285,                  /* LBRACE  */
-    RBRACE = 286,                  /* RBRACE  */
-    LBRACKET = 287,                /* LBRACKET  */
-    RBRACKET = 288,                /* RBRACKET  */
-    SEMI = 289,                    /* SEMI  */
-    COMMA = 290,                   /* COMMA  */
-    DOT = 291,                     /* DOT  */
-    SCOPE = 292,                   /* SCOPE  */
-    COLON = 293,                   /* COLON  */
-    CLASS = 294,                   /* CLASS  */
-    FUNC = 295,                    /* FUNC  */
-    IMPLEMENT = 296,               /* IMPLEMENT  */
-    ISA = 297,                     /* ISA  */
-    PRIVATE = 298,                 /* PRIVATE  */
-    PUBLIC = 299,                  /* PUBLIC  */
-    LOCAL = 300,                   /* LOCAL  */
-    ATTRIBUTE = 301,               /* ATTRIBUTE  */
-    ID = 302,                      /* ID  */
-    INT = 303,                     /* INT  */
-    FLOAT = 304,                   /* FLOAT  */
-    STRING = 305,                  /* STRING  */
-    ERROR = 306                    /* ERROR  */
-  };
-  typedef enum yytokentype yytoken_kind_t;
-#endif
-
-/* Value type.  */
-#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef int YYSTYPE;
-# define YYSTYPE_IS_TRIVIAL 1
-# define YYSTYPE_IS_DECLARED 1
-#endif
-
-
-extern YYSTYPE yylval;
-
-
-int yyparse (void);
-
-
-#endif /* !YY_YY_PARSER_TAB_H_INCLUDED  */
@@ -1,23 +1,75 @@
 %{
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include "cache.h"
+#include "cgen.h"
+#include "check.h"
+#include "files.h"
+#include "interp.h"
+#include "keywords.h"
+#include "parlex.h"
+#include "pool.h"
+%}
+
+%code requires {
+#include "context.h"
+}
 
+%code {
 // External reference to Flex
-int yylex();
-void yyerror(const char *s);
-extern void print_symbol_table();
-extern int line, column;
-extern FILE *yyin;  // For file input
-%}
+int scanner_lex(YYSTYPE *lval, void *scanner);
+int push_lex(YYSTYPE *lval, ParseContext *ctx);
+static int yylex(YYSTYPE *lval, ParseContext *ctx);
+void yyerror(ParseContext *ctx, const char *s);
+static NodeId add_class(ParseContext *ctx, NodeId list, NodeId cls);
+
+#define AST (&ctx->ast)
+#define ERROR_NODE(line) ast_new(AST, AST_ERROR, (line), 0, 0, 0)
+
+// Resynchronized after a syntax error: report the next one right away,
+// unless the limit has been reached
+#define RECOVERED() \
+    do { \
+        yyerrok; \
+        if (ctx->max_errors && ctx->errors >= ctx->max_errors) \
+            YYABORT; \
+    } while (0)
+#define LEXEME(tok) intern_str(&ctx->symbol_table.strings, (tok).sym), intern_len(&ctx->symbol_table.strings, (tok).sym)
+}
+
+%union {
+    NodeId node;
+    int flags;
+    struct {
+        SymbolId sym;
+        uint32_t line;
+    } tok;
+}
+
+%define api.pure full
+%define api.push-pull both
+%parse-param {ParseContext *ctx}
+%lex-param {ParseContext *ctx}
 
 /* Token Declarations */
-%token IF ELSE WHILE THEN READ WRITE RETURN
-%token INTEGER_KW FLOAT_KW VOID
-%token EQ ASSIGN EQUALS LE GE LT GT NE PLUS MINUS MULT DIV
-%token AND OR NOT
-%token LPAREN RPAREN LBRACE RBRACE LBRACKET RBRACKET SEMI COMMA DOT SCOPE COLON
-%token CLASS FUNC IMPLEMENT ISA PRIVATE PUBLIC LOCAL ATTRIBUTE
-%token ID INT FLOAT STRING ERROR
+%token <tok> IF ELSE WHILE THEN READ WRITE RETURN
+%token <tok> INTEGER_KW FLOAT_KW VOID
+%token <tok> EQ ASSIGN EQUALS LE GE LT GT NE PLUS MINUS MULT DIV
+%token <tok> AND OR NOT
+%token <tok> LPAREN RPAREN LBRACE RBRACE LBRACKET RBRACKET SEMI COMMA DOT SCOPE COLON
+%token <tok> CLASS FUNC IMPLEMENT ISA PRIVATE PUBLIC LOCAL ATTRIBUTE
+%token <tok> ID INT FLOAT STRING ERROR
+
+%type <node> program class_list class_decl ID_list member_list member
+%type <node> field_decl method_decl param_list param stmt_list stmt
+%type <node> assignment_stmt return_stmt block_stmt decl_stmt type expr_stmt
+%type <node> if_stmt while_stmt io_stmt expr arg_list
+%type <flags> visibility
 
 %left OR
 %left AND
@@ -32,69 +84,90 @@ extern FILE *yyin;  // For file input
 %%
 
 program:
-    class_list
-    | stmt_list
+    class_list                  { $$ = ctx->root = ast_new(AST, AST_PROGRAM, 1, $1, 0, 0); }
+    | stmt_list                 { $$ = ctx->root = ast_new(AST, AST_PROGRAM, 1, 0, $1, 0); }
     ;
 
 class_list:
-    class_list class_decl
-    | class_decl
+    class_list class_decl       { $$ = add_class(ctx, $1, $2); }
+    | class_decl                { $$ = add_class(ctx, 0, $1); }
     ;
 
 class_decl:
     CLASS ID LBRACE member_list RBRACE
+        { $$ = ast_named(AST, AST_CLASS, $1.line, $2.sym, 0, $4, 0); }
     | CLASS ID ISA ID LBRACE member_list RBRACE
+        { $$ = ast_named(AST, AST_CLASS, $1.line, $2.sym,
+                         ast_list(AST, ast_named(AST, AST_NAME, $4.line, $4.sym, 0, 0, 0)), $6, 0); }
     | CLASS ID ISA ID_list LBRACE member_list RBRACE
+        { $$ = ast_named(AST, AST_CLASS, $1.line, $2.sym, $4, $6, 0); }
+    | CLASS error LBRACE { RECOVERED(); } member_list RBRACE
+        { $$ = ERROR_NODE($1.line); }
+    | CLASS error RBRACE        { $$ = ERROR_NODE($1.line); RECOVERED(); }
     ;
 
 ID_list:
-    ID_list COMMA ID
-    | ID
+    ID_list COMMA ID            { $$ = ast_append(AST, $1, ast_named(AST, AST_NAME, $3.line, $3.sym, 0, 0, 0)); }
+    | ID                        { $$ = ast_list(AST, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0)); }
     ;
 
 member_list:
-    member_list member
-    | member
+    member_list member          { $$ = ast_append(AST, $1, $2); }
+    | member                    { $$ = ast_list(AST, $1); }
     ;
 
 member:
     field_decl
     | method_decl
-    | visibility field_decl
-    | visibility method_decl
+    | visibility field_decl     { $$ = $2; ast_at(AST, $$)->flags |= $1; }
+    | visibility method_decl    { $$ = $2; ast_at(AST, $$)->flags |= $1; }
+    | error SEMI                { $$ = ERROR_NODE($2.line); RECOVERED(); }
+    | FUNC ID error LBRACE { RECOVERED(); } stmt_list RBRACE
+        { $$ = ERROR_NODE($1.line); }
     ;
 
 visibility:
-    PUBLIC
-    | PRIVATE
+    PUBLIC                      { $$ = AST_PUBLIC; }
+    | PRIVATE                   { $$ = AST_PRIVATE; }
     ;
 
 field_decl:
     type ID SEMI
+        { $$ = ast_named(AST, AST_FIELD, $2.line, $2.sym, $1, 0, 0); }
     | type ID LBRACKET INT RBRACKET SEMI
+        { $$ = ast_named(AST, AST_FIELD, $2.line, $2.sym, $1,
+                         ast_literal(AST, AST_INT, $4.line, LEXEME($4)), 0); }
     | type ID LBRACKET ID RBRACKET LBRACKET INT RBRACKET SEMI
+        { $$ = ast_named(AST, AST_FIELD, $2.line, $2.sym, $1,
+                         ast_named(AST, AST_NAME, $4.line, $4.sym, 0, 0, 0),
+                         ast_literal(AST, AST_INT, $7.line, LEXEME($7))); }
     ;
 
 method_decl:
     FUNC ID LPAREN param_list RPAREN COLON type LBRACE stmt_list RBRACE
+        { $$ = ast_named(AST, AST_METHOD, $1.line, $2.sym, $4, $7, $9); }
     | FUNC ID LPAREN RPAREN COLON type LBRACE stmt_list RBRACE
+        { $$ = ast_named(AST, AST_METHOD, $1.line, $2.sym, 0, $6, $8); }
     | FUNC ID LPAREN param_list RPAREN LBRACE stmt_list RBRACE
+        { $$ = ast_named(AST, AST_METHOD, $1.line, $2.sym, $4, 0, $7); }
     | FUNC ID LPAREN RPAREN LBRACE stmt_list RBRACE
+        { $$ = ast_named(AST, AST_METHOD, $1.line, $2.sym, 0, 0, $6); }
     ;
 
 param_list:
-    param_list COMMA param
-    | param
+    param_list COMMA param      { $$ = ast_append(AST, $1, $3); }
+    | param                     { $$ = ast_list(AST, $1); }
     ;
 
 param:
-    type ID
+    type ID                     { $$ = ast_named(AST, AST_PARAM, $2.line, $2.sym, $1, 0, 0); }
     | type ID LBRACKET RBRACKET
+        { $$ = ast_named(AST, AST_PARAM, $2.line, $2.sym, $1, 0, 0); ast_at(AST, $$)->flags = AST_ARRAY; }
     ;
 
 stmt_list:
-    stmt_list stmt
-    | stmt
+    stmt_list stmt              { $$ = ast_append(AST, $1, $2); }
+    | stmt                      { $$ = ast_list(AST, $1); }
     ;
 
 stmt:
@@ -106,127 +179,863 @@ stmt:
     | block_stmt
     | return_stmt
     | assignment_stmt
+    | error SEMI                { $$ = ERROR_NODE($2.line); RECOVERED(); }
     ;
 
 assignment_stmt:
     ID DOT ID EQUALS expr SEMI
+        { $$ = ast_new(AST, AST_ASSIGN, $1.line,
+                       ast_named(AST, AST_MEMBER, $1.line, $3.sym,
+                                 ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), 0, 0), $5, 0); }
     | ID LBRACKET expr RBRACKET EQUALS expr SEMI
+        { $$ = ast_new(AST, AST_ASSIGN, $1.line,
+                       ast_new(AST, AST_INDEX, $1.line,
+                               ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), $3, 0), $6, 0); }
     | ID LBRACKET expr RBRACKET LBRACKET expr RBRACKET EQUALS expr SEMI
+        { $$ = ast_new(AST, AST_ASSIGN, $1.line,
+                       ast_new(AST, AST_INDEX, $1.line,
+                               ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), $3, $6), $9, 0); }
     ;
 
 return_stmt:
-    RETURN expr SEMI
-    | RETURN SEMI
+    RETURN expr SEMI            { $$ = ast_new(AST, AST_RETURN, $1.line, $2, 0, 0); }
+    | RETURN SEMI               { $$ = ast_new(AST, AST_RETURN, $1.line, 0, 0, 0); }
     ;
 
 block_stmt:
-    LBRACE stmt_list RBRACE
-    | LBRACE RBRACE
+    LBRACE stmt_list RBRACE     { $$ = ast_new(AST, AST_BLOCK, $1.line, $2, 0, 0); }
+    | LBRACE RBRACE             { $$ = ast_new(AST, AST_BLOCK, $1.line, 0, 0, 0); }
     ;
 
 decl_stmt:
-    type ID ASSIGN expr SEMI
-    | type ID SEMI
+    type ID ASSIGN expr SEMI    { $$ = ast_named(AST, AST_DECL, $2.line, $2.sym, $1, $4, 0); }
+    | type ID SEMI              { $$ = ast_named(AST, AST_DECL, $2.line, $2.sym, $1, 0, 0); }
     | LOCAL type ID ASSIGN expr SEMI
+        { $$ = ast_named(AST, AST_DECL, $3.line, $3.sym, $2, $5, 0); ast_at(AST, $$)->flags = AST_LOCAL; }
     | LOCAL type ID SEMI
+        { $$ = ast_named(AST, AST_DECL, $3.line, $3.sym, $2, 0, 0); ast_at(AST, $$)->flags = AST_LOCAL; }
     ;
 
 type:
-    INTEGER_KW
-    | FLOAT_KW
-    | VOID
-    | ID
+    INTEGER_KW                  { $$ = ast_new(AST, AST_TYPE, $1.line, 0, 0, 0); ast_at(AST, $$)->op = TYPE_INTEGER; }
+    | FLOAT_KW                  { $$ = ast_new(AST, AST_TYPE, $1.line, 0, 0, 0); ast_at(AST, $$)->op = TYPE_FLOAT; }
+    | VOID                      { $$ = ast_new(AST, AST_TYPE, $1.line, 0, 0, 0); ast_at(AST, $$)->op = TYPE_VOID; }
+    | ID                        { $$ = ast_named(AST, AST_TYPE, $1.line, $1.sym, 0, 0, 0); ast_at(AST, $$)->op = TYPE_CLASS; }
     ;
 
 expr_stmt:
     ID ASSIGN expr SEMI
+        { $$ = ast_new(AST, AST_ASSIGN, $1.line, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), $3, 0); }
     | ID EQUALS expr SEMI
+        { $$ = ast_new(AST, AST_ASSIGN, $1.line, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), $3, 0); }
     ;
 
 if_stmt:
-    IF LPAREN expr RPAREN THEN stmt ELSE stmt
-    | IF LPAREN expr RPAREN THEN stmt
-    | IF LPAREN expr RPAREN stmt ELSE stmt
-    | IF LPAREN expr RPAREN stmt
+    IF LPAREN expr RPAREN THEN stmt ELSE stmt   { $$ = ast_new(AST, AST_IF, $1.line, $3, $6, $8); }
+    | IF LPAREN expr RPAREN THEN stmt           { $$ = ast_new(AST, AST_IF, $1.line, $3, $6, 0); }
+    | IF LPAREN expr RPAREN stmt ELSE stmt      { $$ = ast_new(AST, AST_IF, $1.line, $3, $5, $7); }
+    | IF LPAREN expr RPAREN stmt                { $$ = ast_new(AST, AST_IF, $1.line, $3, $5, 0); }
     ;
 
 while_stmt:
-    WHILE LPAREN expr RPAREN stmt
+    WHILE LPAREN expr RPAREN stmt               { $$ = ast_new(AST, AST_WHILE, $1.line, $3, $5, 0); }
     ;
 
 io_stmt:
     READ LPAREN ID RPAREN SEMI
+        { $$ = ast_new(AST, AST_READ, $1.line, ast_named(AST, AST_NAME, $3.line, $3.sym, 0, 0, 0), 0, 0); }
     | READ LPAREN ID DOT ID RPAREN SEMI
+        { $$ = ast_new(AST, AST_READ, $1.line,
+                       ast_named(AST, AST_MEMBER, $3.line, $5.sym,
+                                 ast_named(AST, AST_NAME, $3.line, $3.sym, 0, 0, 0), 0, 0), 0, 0); }
     | READ LPAREN ID LBRACKET expr RBRACKET RPAREN SEMI
+        { $$ = ast_new(AST, AST_READ, $1.line,
+                       ast_new(AST, AST_INDEX, $3.line,
+                               ast_named(AST, AST_NAME, $3.line, $3.sym, 0, 0, 0), $5, 0), 0, 0); }
     | WRITE LPAREN expr RPAREN SEMI
+        { $$ = ast_new(AST, AST_WRITE, $1.line, $3, 0, 0); }
     ;
 
 expr:
-    expr PLUS expr
-    | expr MINUS expr
-    | expr MULT expr
-    | expr DIV expr
-    | expr LT expr
-    | expr GT expr
-    | expr LE expr
-    | expr GE expr
-    | expr EQ expr
-    | expr NE expr
-    | expr AND expr
-    | expr OR expr
-    | NOT expr
-    | LPAREN expr RPAREN
-    | ID
+    expr PLUS expr              { $$ = ast_binary(AST, PLUS, $1, $3); }
+    | expr MINUS expr           { $$ = ast_binary(AST, MINUS, $1, $3); }
+    | expr MULT expr            { $$ = ast_binary(AST, MULT, $1, $3); }
+    | expr DIV expr             { $$ = ast_binary(AST, DIV, $1, $3); }
+    | expr LT expr              { $$ = ast_binary(AST, LT, $1, $3); }
+    | expr GT expr              { $$ = ast_binary(AST, GT, $1, $3); }
+    | expr LE expr              { $$ = ast_binary(AST, LE, $1, $3); }
+    | expr GE expr              { $$ = ast_binary(AST, GE, $1, $3); }
+    | expr EQ expr              { $$ = ast_binary(AST, EQ, $1, $3); }
+    | expr NE expr              { $$ = ast_binary(AST, NE, $1, $3); }
+    | expr AND expr             { $$ = ast_binary(AST, AND, $1, $3); }
+    | expr OR expr              { $$ = ast_binary(AST, OR, $1, $3); }
+    | NOT expr                  { $$ = ast_new(AST, AST_NOT, $1.line, $2, 0, 0); }
+    | LPAREN expr RPAREN        { $$ = $2; }
+    | ID                        { $$ = ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0); }
     | ID DOT ID
+        { $$ = ast_named(AST, AST_MEMBER, $1.line, $3.sym, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), 0, 0); }
     | ID LBRACKET expr RBRACKET
+        { $$ = ast_new(AST, AST_INDEX, $1.line, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), $3, 0); }
     | ID LBRACKET expr RBRACKET LBRACKET expr RBRACKET
+        { $$ = ast_new(AST, AST_INDEX, $1.line, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), $3, $6); }
     | ID LPAREN arg_list RPAREN
+        { $$ = ast_named(AST, AST_CALL, $1.line, $1.sym, 0, $3, 0); ast_at(AST, $$)->op = CALL_FUNCTION; }
     | ID LPAREN RPAREN
+        { $$ = ast_named(AST, AST_CALL, $1.line, $1.sym, 0, 0, 0); ast_at(AST, $$)->op = CALL_FUNCTION; }
     | ID DOT ID LPAREN arg_list RPAREN
+        { $$ = ast_named(AST, AST_CALL, $1.line, $3.sym, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), $5, 0);
+          ast_at(AST, $$)->op = CALL_METHOD; }
     | ID DOT ID LPAREN RPAREN
+        { $$ = ast_named(AST, AST_CALL, $1.line, $3.sym, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), 0, 0);
+          ast_at(AST, $$)->op = CALL_METHOD; }
     | ID SCOPE ID LPAREN arg_list RPAREN
+        { $$ = ast_named(AST, AST_CALL, $1.line, $3.sym, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), $5, 0);
+          ast_at(AST, $$)->op = CALL_SCOPED; }
     | ID SCOPE ID LPAREN RPAREN
-    | INT
-    | FLOAT
-    | STRING
+        { $$ = ast_named(AST, AST_CALL, $1.line, $3.sym, ast_named(AST, AST_NAME, $1.line, $1.sym, 0, 0, 0), 0, 0);
+          ast_at(AST, $$)->op = CALL_SCOPED; }
+    | INT                       { $$ = ast_literal(AST, AST_INT, $1.line, LEXEME($1)); }
+    | FLOAT                     { $$ = ast_literal(AST, AST_FLOAT, $1.line, LEXEME($1)); }
+    | STRING                    { $$ = ast_named(AST, AST_STRING, $1.line, $1.sym, 0, 0, 0); }
     ;
 
 arg_list:
-    arg_list COMMA expr
-    | expr
+    arg_list COMMA expr         { $$ = ast_append(AST, $1, $3); }
+    | expr                      { $$ = ast_list(AST, $1); }
     ;
 
 %%
 
-void yyerror(const char *s) {
-    fprintf(stderr, "Syntax Error at line %d, column %d: %s\n", line, column, s);
+// Counts come from here rather than the scanner, so tokens replayed after
+// a parallel lex are counted too
+static void token_value(ParseContext *ctx, YYSTYPE *lval, int token) {
+    int line, column;
+
+    // Indexed by token code, so the %token order doesn't matter; ERROR
+    // stands for a lexical error rather than a token and isn't counted
+    if (ctx->stats && token != ERROR && token >= 0 && token < STATS_TOKEN_CODES)
+        ctx->stats->tokens[token]++;
+    line_index_find(&ctx->lines, &ctx->line_hint, ctx->token_offset, &line, &column);
+    lval->tok.sym = ctx->token;
+    lval->tok.line = (uint32_t)line;
+}
+
+static int yylex(YYSTYPE *lval, ParseContext *ctx) {
+    int token = ctx->replay ? parlex_next(ctx) : scanner_lex(lval, ctx->scanner);
+
+    token_value(ctx, lval, token);
+    return token;
+}
+
+// Between pushes the parser waits for a token, with its stack at the depth
+// the input so far has reached
+static void note_depth(ParseContext *ctx, const yypstate *ps) {
+    int depth = (int)(ps->yyssp - ps->yyss) + 1;
+
+    if (depth > ctx->stats->max_depth)
+        ctx->stats->max_depth = depth;
+}
+
+// Pushes len bytes of input to a context from context_open_push(), or ends
+// the input if len is 0, and parses as far as the input allows. Returns
+// PUSH_MORE while the parser wants more input, then the yyparse() result.
+// Callers must end the input unless the parse finished early.
+int parse_push(ParseContext *ctx, const char *buf, size_t len) {
+    PushInput *in = ctx->push;
+    StatsLoop loop;
+    YYSTYPE lval;
+    int token;
+
+    if (in->result != PUSH_MORE)
+        return in->result;
+    if (!in->parser && !(in->parser = yypstate_new()))
+        return in->result = 2;
+    if (push_input(ctx, buf, len) != 0)
+        return 2;
+    if (ctx->stats)
+        stats_loop_begin(ctx->stats, &loop);
+    while ((token = push_lex(&lval, ctx)) >= 0) {
+        int status;
+
+        token_value(ctx, &lval, token);
+        if (ctx->stats)
+            stats_lexed(&loop);
+        status = yypush_parse(in->parser, token, &lval, ctx);
+        if (ctx->stats) {
+            stats_parsed(&loop);
+            note_depth(ctx, in->parser);
+        }
+        if (status != YYPUSH_MORE) {
+            yypstate_delete(in->parser);
+            in->parser = NULL;
+            in->result = status == 0 && ctx->errors ? 1 : status;
+            break;
+        }
+    }
+    if (ctx->stats)
+        stats_loop_end(ctx->stats, &loop);
+    return in->result;
+}
+
+void yyerror(ParseContext *ctx, const char *s) {
+    int line, column;
+
+    if (ctx->max_errors && ctx->errors >= ctx->max_errors)
+        return;
+    ctx->errors++;
+    line_index_find(&ctx->lines, NULL, ctx->offset, &line, &column);
+    fprintf(ctx->err, "Syntax Error at line %d, column %d: %s\n", line, column, s);
+    if (ctx->errors == ctx->max_errors)
+        fprintf(ctx->err, "Too many errors, giving up\n");
+}
+
+// Nothing reads the tree while streaming, so each finished class is dropped
+// and node storage stays at the size of the largest class
+static NodeId add_class(ParseContext *ctx, NodeId list, NodeId cls) {
+    if (ctx->on_class)
+        ctx->on_class(ctx, cls, ctx->on_class_arg);
+    if (ctx->stream) {
+        ast_clear(AST);
+        return 0;
+    }
+    return list ? ast_append(AST, list, cls) : ast_list(AST, cls);
+}
+
+// Reads the input in whatever pieces read() returns, as a caller getting
+// source from a pipe or socket would, and parses each piece on arrival
+static int push_file(ParseContext *ctx) {
+    char buf[1 << 16];
+    int fd = fileno(ctx->input_file);
+    ssize_t n;
+    int result;
+
+    do {
+        n = read(fd, buf, sizeof(buf));
+        if (n < 0) {
+            fprintf(ctx->err, "Error: Cannot read '%s'\n", ctx->path);
+            n = 0;
+        }
+        result = parse_push(ctx, buf, (size_t)n);
+    } while (result == PUSH_MORE && n > 0);
+    return result;
+}
+
+// What yyparse() does, driving the push parser instead so that each
+// token's lexing and parsing can be timed apart
+static int parse_measured(ParseContext *ctx) {
+    yypstate *ps = yypstate_new();
+    StatsLoop loop;
+    YYSTYPE lval;
+    int status;
+
+    if (!ps)
+        return 2;
+    stats_loop_begin(ctx->stats, &loop);
+    do {
+        int token = yylex(&lval, ctx);
+
+        stats_lexed(&loop);
+        status = yypush_parse(ps, token, &lval, ctx);
+        stats_parsed(&loop);
+        note_depth(ctx, ps);
+    } while (status == YYPUSH_MORE);
+    stats_loop_end(ctx->stats, &loop);
+    yypstate_delete(ps);
+    return status;
+}
+
+// A parse that recovered from syntax errors still fails. Semantic errors
+// are reported but leave the result alone; they only keep --run from
+// running the program and --emit=c from translating it, as does a failed
+// parse. With --run the result is the program's: 1 unless it ran to the
+// end.
+static int run_parser(ParseContext *ctx) {
+    int result = ctx->push ? push_file(ctx) : ctx->stats ? parse_measured(ctx) : yyparse(ctx);
+    int semantic = 0;
+    StatsTimer timer;
+
+    if (result == 0 && ctx->errors)
+        result = 1;
+    if (ctx->check && ctx->root) {
+        if (ctx->stats)
+            stats_start(ctx->stats, &timer);
+        semantic = check_program(ctx);
+        if (ctx->stats)
+            stats_stop(ctx->stats, STATS_CHECK, &timer);
+    }
+    if (ctx->run && result == 0 && semantic == 0) {
+        if (ctx->stats)
+            stats_start(ctx->stats, &timer);
+        result = interp_run(ctx, ctx->run);
+        if (ctx->stats)
+            stats_stop(ctx->stats, STATS_RUN, &timer);
+    } else if (ctx->run) {
+        result = 1;
+    }
+    if (ctx->translate && result == 0 && semantic == 0)
+        cgen_program(ctx);
+
+    return result;
+}
+
+// Where a parse result is stored besides being reported, when caching
+typedef struct {
+    const Cache *cache;
+    uint64_t key;
+    uint64_t size;
+} CacheSlot;
+
+// Parses with the diagnostics captured, so the cache entry can replay them
+static int parse_and_store(ParseContext *ctx, const CacheSlot *slot) {
+    FILE *out = ctx->out, *err = ctx->err;
+    char *out_text = NULL, *err_text = NULL;
+    size_t out_len = 0, err_len = 0;
+    int result;
+
+    ctx->out = open_memstream(&out_text, &out_len);
+    ctx->err = open_memstream(&err_text, &err_len);
+    if (!ctx->out || !ctx->err) {
+        if (ctx->out)
+            fclose(ctx->out);
+        if (ctx->err)
+            fclose(ctx->err);
+        ctx->out = out;
+        ctx->err = err;
+        return run_parser(ctx);
+    }
+    result = run_parser(ctx);
+    fclose(ctx->out);
+    fclose(ctx->err);
+    ctx->out = out;
+    ctx->err = err;
+    fwrite(err_text, 1, err_len, err);
+    fwrite(out_text, 1, out_len, out);
+    cache_store(slot->cache, slot->key, slot->size, result == 0, out_text, out_len, err_text, err_len,
+                &ctx->symbol_table, &ctx->lines);
+    free(out_text);
+    free(err_text);
+    return result;
+}
+
+static void print_report(ParseContext *ctx, int stream, EmitFormat format, int result) {
+    Emitter dump;
+
+    if (ctx->run || ctx->translate)
+        return;     // the program's output, or its translation, is the output
+    if (format != EMIT_TABLE) {
+        // Token dumps replace the report, so the output is pure data
+        emitter_init(&dump, ctx->out);
+        if (format == EMIT_TOKENS_BIN)
+            emit_tokens_bin(&dump, &ctx->symbol_table, &ctx->lines, ctx->path, result == 0);
+        else
+            emit_tokens_ndjson(&dump, &ctx->symbol_table, &ctx->lines, ctx->path, result == 0);
+        emitter_free(&dump);
+        return;
+    }
+    if (result == 0) {
+        fprintf(ctx->out, "Parsing completed successfully.\n");
+    } else {
+        fprintf(ctx->out, "Parsing failed.\n");
+    }
+    if (!stream)
+        print_symbol_table(ctx);
+}
+
+// Returns 1 if --run did not run the program to the end, else 0; a
+// failed parse is only reported
+static int parse_file(ParseContext *ctx, int stream, EmitFormat format, const CacheSlot *slot) {
+    StatsTimer timer;
+    Emitter dump;
+    int result;
+
+    ctx->translate = format == EMIT_C;
+    if (format == EMIT_TABLE && !ctx->run)
+        fprintf(ctx->out, "Begin parsing file: %s\n", ctx->path);
+    if (stream) {
+        // Rows go out while parsing; the result line follows the table
+        emitter_init(&dump, ctx->out);
+        emit_table_header(&dump);
+        ctx->stream = &dump;
+        result = run_parser(ctx);
+        emit_table_footer(&dump);
+        emitter_free(&dump);
+        ctx->stream = NULL;
+    } else if (slot) {
+        result = parse_and_store(ctx, slot);
+    } else {
+        result = run_parser(ctx);
+    }
+
+    if (ctx->stats)
+        stats_start(ctx->stats, &timer);
+    print_report(ctx, stream, format, result);
+    if (ctx->stats) {
+        stats_stop(ctx->stats, STATS_PRINT, &timer);
+        stats_note_context(ctx->stats, ctx);
+        ctx->stats->files++;
+    }
+    return ctx->run && result != 0;
+}
+
+// Prints the report for path from the cache, the same bytes parse_file
+// wrote when the entry was stored. Returns 1 on a hit; on a miss, slot is
+// set up for storing the result, or left without a cache if path cannot
+// be read.
+static int report_cached(const Cache *cache, const char *path, EmitFormat format,
+                         FILE *out, FILE *err, CacheSlot *slot) {
+    CacheEntry entry;
+    Emitter dump;
+
+    slot->cache = NULL;
+    if (cache_key(cache, path, &slot->key, &slot->size) != 0)
+        return 0;
+    slot->cache = cache;
+    if (cache_load(cache, slot->key, slot->size, &entry) != 0)
+        return 0;
+    fwrite(entry.err_text, 1, entry.err_len, err);
+    if (format == EMIT_TABLE)
+        fprintf(out, "Begin parsing file: %s\n", path);
+    fwrite(entry.out_text, 1, entry.out_len, out);
+    if (format == EMIT_TABLE)
+        fprintf(out, entry.parsed ? "Parsing completed successfully.\n" : "Parsing failed.\n");
+    emitter_init(&dump, out);
+    cache_emit(&entry, &dump, format, path);
+    emitter_free(&dump);
+    cache_entry_close(&entry);
+    return 1;
+}
+
+typedef struct {
+    const char *path;
+    int opened;
+    int failed;             // --run did not finish the program
+    int done;
+    double elapsed_ms;
+    char *out_buf;
+    size_t out_len;
+    char *err_buf;
+    size_t err_len;
+    Stats stats;
+} FileJob;
+
+typedef struct {
+    FileJob *jobs;
+    size_t count;
+    int nworkers;
+    int use_mmap;
+    int stream;
+    EmitFormat format;
+    int max_errors;
+    int check;
+    const char *run;
+    int engine;
+    int fold;
+    int stats;
+    const Cache *cache;
+    size_t cache_hits;      // updated under lock
+    size_t cache_misses;
+    pthread_mutex_t lock;
+    pthread_cond_t job_done;
+} Batch;
+
+static double elapsed_ms(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (now.tv_sec - start->tv_sec) * 1e3 + (now.tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Pool task: parse one file with its own scanner and parser, collecting
+// the report in memory
+static void parse_job(void *arg, size_t index) {
+    Batch *batch = arg;
+    FileJob *job = &batch->jobs[index];
+    ParseContext ctx;
+    CacheSlot slot = { NULL, 0, 0 };
+    Stats *stats = batch->stats ? &job->stats : NULL;
+    StatsTimer timer;
+    struct timespec start;
+    FILE *out, *err;
+    int hit = 0;
+    int opened;
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    out = open_memstream(&job->out_buf, &job->out_len);
+    err = open_memstream(&job->err_buf, &job->err_len);
+    if (stats) {
+        stats_init(stats, CLOCK_THREAD_CPUTIME_ID);
+        stats_start(stats, &timer);
+    }
+    hit = batch->cache && report_cached(batch->cache, job->path, batch->format, out, err, &slot);
+    opened = !hit && context_open(&ctx, job->path, batch->use_mmap) == 0;
+    if (stats) {
+        // A hit is all printing; a lookup that missed was part of opening
+        stats_stop(stats, hit ? STATS_PRINT : STATS_OPEN, &timer);
+        stats->files += hit;
+        stats->cached += hit;
+    }
+    if (hit) {
+        job->opened = 1;
+    } else if (opened) {
+        ctx.out = out;
+        ctx.err = err;
+        ctx.max_errors = batch->max_errors;
+        ctx.check = batch->check;
+        ctx.run = batch->run;
+        ctx.engine = batch->engine;
+        ctx.fold = batch->fold;
+        ctx.workers = 1;        // the files already keep the workers busy
+        ctx.stats = stats;
+        job->failed = parse_file(&ctx, batch->stream, batch->format, slot.cache ? &slot : NULL);
+        context_close(&ctx);
+        job->opened = 1;
+    } else {
+        fprintf(err, "Error: Cannot open file '%s'\n", job->path);
+    }
+    fclose(out);
+    fclose(err);
+    job->elapsed_ms = elapsed_ms(&start);
+
+    pthread_mutex_lock(&batch->lock);
+    if (batch->cache) {
+        if (hit)
+            batch->cache_hits++;
+        else
+            batch->cache_misses++;
+    }
+    job->done = 1;
+    pthread_cond_broadcast(&batch->job_done);
+    pthread_mutex_unlock(&batch->lock);
+}
+
+static void *run_batch(void *arg) {
+    Batch *batch = arg;
+    pool_run(batch->nworkers, batch->count, parse_job, batch);
+    return NULL;
+}
+
+typedef struct {
+    const struct timespec *start;
+    double first_ms;
+} ClassTimer;
+
+static void note_first_class(ParseContext *ctx, NodeId cls, void *arg) {
+    ClassTimer *timer = arg;
+
+    (void)ctx;
+    (void)cls;
+    if (timer->first_ms == 0)
+        timer->first_ms = elapsed_ms(timer->start);
+}
+
+static void usage(const char *prog) {
+    fprintf(stderr, "Usage: %s [--mmap] [--stream] [--emit=table|tokens-bin|tokens-ndjson|c] [--push] [--max-errors=N] [--cache=DIR] [--check] [--run[=CLASS.METHOD]] [--engine=tree|vm|jit] [--no-fold] [--time] [--stats[=json]] [-j N] <input_file|directory|@list|->...\n", prog);
 }
 
 int main(int argc, char *argv[]) {
-    FILE *input_file;
+    PathList inputs = {0};
+    Batch batch;
+    pthread_t runner;
+    struct timespec start;
+    int use_mmap = 0;
+    int stream = 0;
+    int push = 0;
+    int from_stdin = 0;
+    EmitFormat format = EMIT_TABLE;
+    int show_time = 0;
+    int show_stats = 0;
+    int check = 0;
+    const char *run = NULL;
+    int engine = ENGINE_VM;
+    int fold = 1;
+    int stats_json = 0;
+    Stats stats;
+    StatsTimer timer;
+    int max_errors = 20;
+    const char *cache_dir = NULL;
+    Cache cache;
+    int threaded;
+    int nworkers = 0;
+    int status = 0;
+    int i;
+    size_t n;
     
-    if (argc != 2) {
-        fprintf(stderr, "Usage: %s <input_file>\n", argv[0]);
+    for (i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--mmap") == 0) {
+            use_mmap = 1;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream = 1;
+        } else if (strcmp(argv[i], "--push") == 0) {
+            push = 1;
+        } else if (strncmp(argv[i], "--emit=", 7) == 0) {
+            const char *name = argv[i] + 7;
+            if (strcmp(name, "table") == 0) {
+                format = EMIT_TABLE;
+            } else if (strcmp(name, "tokens-bin") == 0) {
+                format = EMIT_TOKENS_BIN;
+            } else if (strcmp(name, "tokens-ndjson") == 0) {
+                format = EMIT_TOKENS_NDJSON;
+            } else if (strcmp(name, "c") == 0) {
+                format = EMIT_C;
+            } else {
+                fprintf(stderr, "Error: Unknown output format '%s'\n", name);
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--max-errors=", 13) == 0) {
+            char *end;
+            max_errors = (int)strtol(argv[i] + 13, &end, 10);
+            if (*end != '\0' || end == argv[i] + 13 || max_errors < 0) {
+                usage(argv[0]);
+                return 1;
+            }
+        } else if (strncmp(argv[i], "--cache=", 8) == 0 && argv[i][8] != '\0') {
+            cache_dir = argv[i] + 8;
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = 1;
+        } else if (strcmp(argv[i], "--run") == 0) {
+            run = "";
+        } else if (strncmp(argv[i], "--run=", 6) == 0 && strchr(argv[i] + 6, '.')) {
+            run = argv[i] + 6;
+        } else if (strcmp(argv[i], "--engine=tree") == 0) {
+            engine = ENGINE_TREE;
+        } else if (strcmp(argv[i], "--engine=vm") == 0) {
+            engine = ENGINE_VM;
+        } else if (strcmp(argv[i], "--engine=jit") == 0) {
+            engine = ENGINE_JIT;
+        } else if (strcmp(argv[i], "--no-fold") == 0) {
+            fold = 0;
+        } else if (strcmp(argv[i], "--time") == 0) {
+            show_time = 1;
+        } else if (strcmp(argv[i], "--stats") == 0 || strcmp(argv[i], "--stats=text") == 0) {
+            show_stats = 1;
+        } else if (strcmp(argv[i], "--stats=json") == 0) {
+            show_stats = stats_json = 1;
+        } else if (strncmp(argv[i], "-j", 2) == 0) {
+            const char *value = argv[i][2] ? argv[i] + 2 : (i + 1 < argc ? argv[++i] : "");
+            char *end;
+            long workers = strtol(value, &end, 10);
+            if (*end != '\0' || end == value || workers < 1 || workers > INT_MAX) {
+                usage(argv[0]);
+                return 1;
+            }
+            nworkers = (int)workers;
+        } else if (argv[i][0] == '-' && argv[i][1] != '\0') {
+            fprintf(stderr, "Error: Unknown option '%s'\n", argv[i]);
+            usage(argv[0]);
+            return 1;
+        } else if (collect_inputs(&inputs, argv[i]) != 0) {
+            status = 1;
+        }
+    }
+    if (stream && format != EMIT_TABLE) {
+        fprintf(stderr, "Error: --stream only applies to the table output\n");
+        path_list_free(&inputs);
         return 1;
     }
-    
-    input_file = fopen(argv[1], "r");
-    if (!input_file) {
-        fprintf(stderr, "Error: Cannot open file '%s'\n", argv[1]);
+    // Standard input can only be read as it arrives, so "-" goes to the
+    // push parser whether or not --push was given
+    for (n = 0; n < inputs.count; n++) {
+        if (strcmp(inputs.paths[n], "-") == 0) {
+            if (inputs.count > 1) {
+                fprintf(stderr, "Error: '-' must be the only input\n");
+                path_list_free(&inputs);
+                return 1;
+            }
+            push = 1;
+            from_stdin = 1;
+        }
+    }
+    if (push && inputs.count > 1) {
+        fprintf(stderr, "Error: --push takes a single input\n");
+        path_list_free(&inputs);
+        return 1;
+    }
+    if (cache_dir && (stream || push || format == EMIT_C)) {
+        fprintf(stderr, "Error: --cache does not apply to --stream, --push or --emit=c\n");
+        path_list_free(&inputs);
         return 1;
     }
+    if (check && stream) {
+        fprintf(stderr, "Error: --check needs the whole tree and does not apply to --stream\n");
+        path_list_free(&inputs);
+        return 1;
+    }
+    if (run && (stream || cache_dir || format != EMIT_TABLE)) {
+        fprintf(stderr, "Error: --run does not apply to --stream, --cache or --emit\n");
+        path_list_free(&inputs);
+        return 1;
+    }
+    // The program's read statements take standard input, so it can't also
+    // hold the program, and files run side by side would race for it
+    if (run && from_stdin) {
+        fprintf(stderr, "Error: --run cannot read the program from standard input\n");
+        path_list_free(&inputs);
+        return 1;
+    }
+    if (run && inputs.count > 1) {
+        fprintf(stderr, "Error: --run takes a single input\n");
+        path_list_free(&inputs);
+        return 1;
+    }
+    if (cache_dir && cache_init(&cache, cache_dir, max_errors, check) != 0) {
+        fprintf(stderr, "Error: Cannot use cache directory '%s'\n", cache_dir);
+        path_list_free(&inputs);
+        return 1;
+    }
+    if (inputs.count == 0) {
+        if (status == 0)
+            usage(argv[0]);
+        return 1;
+    }
+    if (nworkers == 0)
+        nworkers = pool_default_workers();
+    // With a single input the process works on nothing else, so its CPU
+    // time includes the workers of a parallel lex
+    stats_init(&stats, inputs.count == 1 ? CLOCK_PROCESS_CPUTIME_ID : CLOCK_THREAD_CPUTIME_ID);
+    clock_gettime(CLOCK_MONOTONIC, &start);
     
-    // Set flex to read from file instead of stdin
-    yyin = input_file;
+    if (push) {
+        // "-" reads standard input; the time to the first class shows the
+        // latency a caller pushing the input would see
+        const char *path = inputs.paths[0];
+        ClassTimer first = { &start, 0 };
+        ParseContext ctx;
+        FILE *in;
+
+        stats_start(&stats, &timer);
+        in = strcmp(path, "-") == 0 ? stdin : fopen(path, "r");
+        if (!in || context_open_push(&ctx, path) != 0) {
+            fprintf(stderr, "Error: Cannot open file '%s'\n", path);
+            if (in && in != stdin)
+                fclose(in);
+            path_list_free(&inputs);
+            return 1;
+        }
+        stats_stop(&stats, STATS_OPEN, &timer);
+        ctx.input_file = in;
+        ctx.on_class = note_first_class;
+        ctx.on_class_arg = &first;
+        ctx.max_errors = max_errors;
+        ctx.check = check;
+        ctx.run = run;
+        ctx.engine = engine;
+        ctx.fold = fold;
+        ctx.workers = nworkers;
+        ctx.stats = show_stats ? &stats : NULL;
+        if (parse_file(&ctx, stream, format, NULL) != 0)
+            status = 1;
+        if (in == stdin)
+            ctx.input_file = NULL;
+        context_close(&ctx);
+        if (show_time)
+            fprintf(stderr, "%s: %.3f ms, first class after %.3f ms\n", path, elapsed_ms(&start),
+                    first.first_ms);
+        if (show_stats)
+            stats_print(&stats, stderr, stats_json);
+        path_list_free(&inputs);
+        return status;
+    }
+    if (inputs.count == 1) {
+        ParseContext ctx;
+        CacheSlot slot = { NULL, 0, 0 };
+        int hit;
+
+        stats_start(&stats, &timer);
+        hit = cache_dir && report_cached(&cache, inputs.paths[0], format, stdout, stderr, &slot);
+        if (hit) {
+            stats_stop(&stats, STATS_PRINT, &timer);
+            stats.files = stats.cached = 1;
+        } else {
+            // A single large file is split across the workers instead
+            if ((stream || nworkers < 2 || context_open_parallel(&ctx, inputs.paths[0], nworkers) != 0) &&
+                context_open(&ctx, inputs.paths[0], use_mmap) != 0) {
+                fprintf(stderr, "Error: Cannot open file '%s'\n", inputs.paths[0]);
+                path_list_free(&inputs);
+                return 1;
+            }
+            // Opening for a parallel lex does the lexing
+            stats_stop(&stats, ctx.replay ? STATS_LEX : STATS_OPEN, &timer);
+            ctx.max_errors = max_errors;
+            ctx.check = check;
+            ctx.run = run;
+            ctx.engine = engine;
+            ctx.fold = fold;
+            ctx.workers = nworkers;
+            ctx.stats = show_stats ? &stats : NULL;
+            if (parse_file(&ctx, stream, format, slot.cache ? &slot : NULL) != 0)
+                status = 1;
+            context_close(&ctx);
+        }
+        if (show_time)
+            fprintf(stderr, "%s: %.3f ms\n", inputs.paths[0], elapsed_ms(&start));
+        if (cache_dir)
+            fprintf(stderr, "Cache: %d hits, %d misses\n", hit, !hit);
+        if (show_stats)
+            stats_print(&stats, stderr, stats_json);
+        path_list_free(&inputs);
+        return status;
+    }
     
-    printf("Begin parsing file: %s\n", argv[1]);
-    if (yyparse() == 0) {
-        printf("Parsing completed successfully.\n");
-    } else {
-        printf("Parsing failed.\n");
+    // Files are parsed on the worker pool while this thread prints the
+    // finished reports in input order, so output never depends on scheduling
+    batch.jobs = calloc(inputs.count, sizeof(FileJob));
+    if (!batch.jobs) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 1;
+    }
+    batch.count = inputs.count;
+    batch.nworkers = nworkers;
+    batch.use_mmap = use_mmap;
+    batch.stream = stream;
+    batch.format = format;
+    batch.max_errors = max_errors;
+    batch.check = check;
+    batch.run = run;
+    batch.engine = engine;
+    batch.fold = fold;
+    batch.stats = show_stats;
+    batch.cache = cache_dir ? &cache : NULL;
+    batch.cache_hits = batch.cache_misses = 0;
+    for (n = 0; n < inputs.count; n++)
+        batch.jobs[n].path = inputs.paths[n];
+    pthread_mutex_init(&batch.lock, NULL);
+    pthread_cond_init(&batch.job_done, NULL);
+    threaded = pthread_create(&runner, NULL, run_batch, &batch) == 0;
+    if (!threaded)
+        run_batch(&batch);
+    
+    for (n = 0; n < batch.count; n++) {
+        FileJob *job = &batch.jobs[n];
+        pthread_mutex_lock(&batch.lock);
+        while (!job->done)
+            pthread_cond_wait(&batch.job_done, &batch.lock);
+        pthread_mutex_unlock(&batch.lock);
+        
+        fflush(stdout);
+        fwrite(job->err_buf, 1, job->err_len, stderr);
+        fwrite(job->out_buf, 1, job->out_len, stdout);
+        free(job->out_buf);
+        free(job->err_buf);
+        if (!job->opened || job->failed)
+            status = 1;
+        if (show_stats)
+            stats_merge(&stats, &job->stats);
+        if (show_time)
+            fprintf(stderr, "%s: %.3f ms\n", job->path, job->elapsed_ms);
     }
+    if (threaded)
+        pthread_join(runner, NULL);
+    if (show_time)
+        fprintf(stderr, "Parsed %zu files in %.3f ms with %d threads\n",
+                batch.count, elapsed_ms(&start), nworkers);
+    if (cache_dir)
+        fprintf(stderr, "Cache: %zu hits, %zu misses\n", batch.cache_hits, batch.cache_misses);
+    if (show_stats)
+        stats_print(&stats, stderr, stats_json);
     
-    fclose(input_file);
-    print_symbol_table();
-    return 0;
+    pthread_cond_destroy(&batch.job_done);
+    pthread_mutex_destroy(&batch.lock);
+    free(batch.jobs);
+    path_list_free(&inputs);
+    return status;
 }
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "pool.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+typedef struct {
+    pthread_mutex_t lock;
+    size_t *tasks;
+    size_t head;  // owner takes from here
+    size_t tail;  // thieves take from here
+} WorkQueue;
+
+typedef struct {
+    WorkQueue *queues;
+    int nworkers;
+    PoolFn fn;
+    void *arg;
+} Pool;
+
+typedef struct {
+    Pool *pool;
+    int id;
+} Worker;
+
+static int queue_pop(WorkQueue *q, size_t *task) {
+    int found = 0;
+
+    pthread_mutex_lock(&q->lock);
+    if (q->head < q->tail) {
+        *task = q->tasks[q->head++];
+        found = 1;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return found;
+}
+
+static int queue_steal(WorkQueue *q, size_t *task) {
+    int found = 0;
+
+    pthread_mutex_lock(&q->lock);
+    if (q->head < q->tail) {
+        *task = q->tasks[--q->tail];
+        found = 1;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return found;
+}
+
+static void *worker_main(void *arg) {
+    Worker *w = arg;
+    Pool *pool = w->pool;
+    size_t task;
+    int i;
+
+    for (;;) {
+        if (!queue_pop(&pool->queues[w->id], &task)) {
+            // Tasks are never added after start, so once every queue is
+            // empty there is nothing left to steal
+            for (i = 1; i < pool->nworkers; i++) {
+                if (queue_steal(&pool->queues[(w->id + i) % pool->nworkers], &task))
+                    break;
+            }
+            if (i >= pool->nworkers)
+                return NULL;
+        }
+        pool->fn(pool->arg, task);
+    }
+}
+
+void pool_run(int nworkers, size_t ntasks, PoolFn fn, void *arg) {
+    Pool pool;
+    Worker *workers;
+    pthread_t *threads;
+    char *started;
+    size_t *tasks;
+    size_t per_queue;
+    size_t t;
+    int i;
+
+    if (nworkers < 1)
+        nworkers = 1;
+    if ((size_t)nworkers > ntasks)
+        nworkers = ntasks > 0 ? (int)ntasks : 1;
+
+    per_queue = (ntasks + nworkers - 1) / nworkers;
+    pool.queues = calloc(nworkers, sizeof(WorkQueue));
+    workers = calloc(nworkers, sizeof(Worker));
+    threads = calloc(nworkers, sizeof(pthread_t));
+    started = calloc(nworkers, 1);
+    tasks = calloc(per_queue * nworkers + 1, sizeof(size_t));
+    if (!pool.queues || !workers || !threads || !started || !tasks) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    pool.nworkers = nworkers;
+    pool.fn = fn;
+    pool.arg = arg;
+
+    // Deal tasks round-robin so the earliest tasks start first on every worker
+    for (i = 0; i < nworkers; i++) {
+        pthread_mutex_init(&pool.queues[i].lock, NULL);
+        pool.queues[i].tasks = tasks + (size_t)i * per_queue;
+    }
+    for (t = 0; t < ntasks; t++) {
+        WorkQueue *q = &pool.queues[t % nworkers];
+        q->tasks[q->tail++] = t;
+    }
+
+    for (i = 0; i < nworkers; i++) {
+        workers[i].pool = &pool;
+        workers[i].id = i;
+        // A worker that fails to start leaves its queue to the thieves
+        if (i > 0)
+            started[i] = pthread_create(&threads[i], NULL, worker_main, &workers[i]) == 0;
+    }
+    // The calling thread works as worker 0
+    worker_main(&workers[0]);
+    for (i = 1; i < nworkers; i++) {
+        if (started[i])
+            pthread_join(threads[i], NULL);
+    }
+
+    for (i = 0; i < nworkers; i++)
+        pthread_mutex_destroy(&pool.queues[i].lock);
+    free(tasks);
+    free(started);
+    free(threads);
+    free(workers);
+    free(pool.queues);
+}
+
+int pool_default_workers(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    return n > 0 ? (int)n : 1;
+}
@@ -0,0 +1,15 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+typedef void (*PoolFn)(void *arg, size_t task);
+
+// Run fn(arg, task) for every task in [0, ntasks) on nworkers threads and
+// return when all tasks have finished. Tasks are dealt round-robin onto
+// per-worker queues; an idle worker steals from the back of another queue.
+void pool_run(int nworkers, size_t ntasks, PoolFn fn, void *arg);
+
+int pool_default_workers(void);
+
+#endif
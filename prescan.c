@@ -0,0 +1,100 @@
+#include "prescan.h"
+#include <stdint.h>
+
+// Vector width follows the target: AVX2 when the compiler may use it
+// (-mavx2 or -march=native), SSE2 on any x86-64, bytes otherwise
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define VEC_BYTES 32
+typedef __m256i Vec;
+static inline Vec vec_load(const char *p) {
+    return _mm256_loadu_si256((const __m256i *)p);
+}
+static inline uint32_t vec_eq(Vec v, char c) {
+    return (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(c)));
+}
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define VEC_BYTES 16
+typedef __m128i Vec;
+static inline Vec vec_load(const char *p) {
+    return _mm_loadu_si128((const __m128i *)p);
+}
+static inline uint32_t vec_eq(Vec v, char c) {
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(c)));
+}
+#endif
+
+#ifdef VEC_BYTES
+#define VEC_ALL ((uint32_t)((1ull << VEC_BYTES) - 1))
+#endif
+
+static char *skip_blanks(char *p, const char *end) {
+#ifdef VEC_BYTES
+    while (end - p >= VEC_BYTES) {
+        Vec v = vec_load(p);
+        uint32_t other = ~(vec_eq(v, ' ') | vec_eq(v, '\t') | vec_eq(v, '\r') | vec_eq(v, '\n')) & VEC_ALL;
+        if (other)
+            return p + __builtin_ctz(other);
+        p += VEC_BYTES;
+    }
+#endif
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+        p++;
+    return p;
+}
+
+// Newline ending a // comment whose body starts at p, or NULL
+static char *line_comment_end(char *p, const char *end) {
+#ifdef VEC_BYTES
+    while (end - p >= VEC_BYTES) {
+        uint32_t nl = vec_eq(vec_load(p), '\n');
+        if (nl)
+            return p + __builtin_ctz(nl);
+        p += VEC_BYTES;
+    }
+#endif
+    for (; p < end; p++) {
+        if (*p == '\n')
+            return p;
+    }
+    return NULL;
+}
+
+// End of a /* comment whose body starts at p (just past the closing */),
+// or NULL
+static char *block_comment_end(char *p, const char *end) {
+#ifdef VEC_BYTES
+    // Compare each byte and its successor, so a */ across lanes is found too
+    while (end - p > VEC_BYTES) {
+        uint32_t close = vec_eq(vec_load(p), '*') & vec_eq(vec_load(p + 1), '/');
+        if (close)
+            return p + __builtin_ctz(close) + 2;
+        p += VEC_BYTES;
+    }
+#endif
+    for (; end - p >= 2; p++) {
+        if (p[0] == '*' && p[1] == '/')
+            return p + 2;
+    }
+    return NULL;
+}
+
+char *prescan_skip(char *p, const char *end) {
+    char *next;
+
+    for (;;) {
+        p = skip_blanks(p, end);
+        if (end - p < 2 || p[0] != '/')
+            return p;
+        if (p[1] == '/')
+            next = line_comment_end(p + 2, end);
+        else if (p[1] == '*')
+            next = block_comment_end(p + 2, end);
+        else
+            return p;
+        if (!next)
+            return p;
+        p = next;
+    }
+}
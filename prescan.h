@@ -0,0 +1,9 @@
+#ifndef PRESCAN_H
+#define PRESCAN_H
+
+// Skips blanks, newlines and complete comments in [p, end). Stops at the
+// first other byte, or in front of a comment that is not closed before end,
+// so the flex rules only ever see what is left.
+char *prescan_skip(char *p, const char *end);
+
+#endif
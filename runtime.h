@@ -0,0 +1,100 @@
+#ifndef RUNTIME_H
+#define RUNTIME_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "arena.h"
+#include "ast.h"
+#include "context.h"
+#include "hierarchy.h"
+
+// State of one --run, shared by the tree interpreter (interp.c) and the
+// bytecode VM (vm.c). A method runs on whichever engine can take it, and
+// calls cross between the two with evaluated arguments on the value stack.
+
+#define INTERP_STACK_VALUES (1 << 20)  // frame slots of all active tree calls
+#define INTERP_MAX_CALLS 10000
+
+enum { VAL_INT, VAL_FLOAT, VAL_STRING, VAL_OBJECT, VAL_ARRAY };
+
+struct Object;
+struct Array;
+struct VmCode;
+
+typedef union {
+    int64_t i;
+    double f;
+    SymbolId s;             // AST_STRING lexeme, quotes included
+    struct Object *obj;     // NULL until first used
+    struct Array *arr;
+} Word;
+
+typedef struct {
+    uint8_t kind;
+    Word v;
+} Value;
+
+typedef struct Object {
+    uint32_t cls;
+    Value slots[];
+} Object;
+
+typedef struct Array {
+    NodeId decl;            // the AST_FIELD, for the element type
+    uint32_t rows;          // first dimension
+    uint32_t cols;          // second dimension, 0 for a 1-D array
+    Value *data;
+} Array;
+
+// Where each field of a class lives in its objects: the fields of every
+// class in its linearization, bases first
+typedef struct {
+    int32_t *slot_of;       // by field id, -1 if the class has no such field; NULL until needed
+    uint32_t nslots;
+    NodeId *fields;         // declaration in each slot
+} ClassLayout;
+
+typedef struct {
+    ParseContext *ctx;
+    Hierarchy classes;
+    ClassLayout *layouts;
+    uint32_t *info;         // per node: binding of an AST_NAME, slot of an AST_DECL or
+                            // AST_PARAM, id of an AST_FIELD, frame size of an AST_METHOD
+    uint32_t nfields;
+    uint32_t top_frame;     // frame size of a program of bare statements
+    Value *stack;
+    uint32_t sp;
+    uint32_t depth;
+    Value ret;              // value of the last return
+    Arena heap;
+    FILE *in;
+    uint64_t steps;         // statements executed by the tree interpreter
+    int halted;             // a runtime error stopped the run
+    // bytecode engine, see vm.c
+    int vm;                 // compile methods to bytecode where possible
+    struct VmCode **code;   // per AST_METHOD node, compiled on first call
+    Word *regs;             // registers of all active VM calls
+    uint32_t rsp;
+    uint64_t ops;           // bytecode instructions executed
+    int jit;                // promote hot bytecode to machine code, see jit.c
+    uint64_t jitted;        // methods promoted
+} Interp;
+
+extern const Value interp_zero;
+
+void interp_init(Interp *in, ParseContext *ctx);
+void interp_free(Interp *in);
+
+void interp_error(Interp *in, uint32_t line, const char *fmt, ...) __attribute__((format(printf, 3, 4)));
+int interp_decl_type(Interp *in, NodeId decl);
+int interp_is_array(Interp *in, NodeId decl);
+const ClassLayout *interp_layout(Interp *in, uint32_t cls);
+Value *interp_element(Interp *in, Array *arr, int64_t row, int64_t col, int used, uint32_t line);
+Value interp_convert(Interp *in, int type, Value v, uint32_t line);
+Value *interp_member(Interp *in, Object *self, NodeId member, int *type);
+NodeId interp_target(Interp *in, Object *self, NodeId call, Object **receiver);
+Value interp_enter(Interp *in, Object *self, NodeId method, Value *args, uint32_t line);
+Value interp_read(Interp *in, int type);
+void interp_write(Interp *in, Value v, uint32_t line);
+
+#endif
@@ -0,0 +1,131 @@
+#include "scope.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SCOPE_MIN_SLOTS 8
+#define SCOPE_INITIAL_SLAB 1024
+#define SCOPE_INITIAL_DEPTH 16
+
+static void *grow(void *p, size_t size) {
+    p = realloc(p, size);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+// Symbol ids are dense, and multiplying by an odd constant keeps
+// consecutive ids in distinct slots while spreading them out
+static uint32_t slot_of(SymbolId name, uint32_t mask) {
+    return (name * 0x9E3779B1u) & mask;
+}
+
+static void reserve(ScopeTable *t, uint32_t slots) {
+    if (slots <= t->capacity)
+        return;
+    while (t->capacity < slots)
+        t->capacity = t->capacity ? t->capacity * 2 : SCOPE_INITIAL_SLAB;
+    t->slots = grow(t->slots, (size_t)t->capacity * sizeof(Symbol));
+}
+
+// Opens a scope with room for about hint names before it has to grow
+void scope_push(ScopeTable *t, uint32_t hint) {
+    Scope *s;
+    uint32_t n = SCOPE_MIN_SLOTS;
+
+    while (n < hint * 2)
+        n *= 2;
+    if (t->depth == t->max_depth) {
+        t->max_depth = t->max_depth ? t->max_depth * 2 : SCOPE_INITIAL_DEPTH;
+        t->scopes = grow(t->scopes, (size_t)t->max_depth * sizeof(Scope));
+    }
+    reserve(t, t->used + n);
+    s = &t->scopes[t->depth++];
+    s->base = t->used;
+    s->mask = n - 1;
+    s->count = 0;
+    memset(&t->slots[s->base], 0, (size_t)n * sizeof(Symbol));
+    t->used += n;
+}
+
+void scope_pop(ScopeTable *t) {
+    t->used = t->scopes[--t->depth].base;
+}
+
+static Symbol *probe(const ScopeTable *t, const Scope *s, SymbolId name) {
+    Symbol *table = &t->slots[s->base];
+    uint32_t slot;
+
+    for (slot = slot_of(name, s->mask); table[slot].decl; slot = (slot + 1) & s->mask) {
+        if (table[slot].name == name)
+            return &table[slot];
+    }
+    return &table[slot];
+}
+
+// The innermost scope is the top slice of the slab: rehash into the space
+// above it, then move the doubled table down to where it started
+static void scope_grow(ScopeTable *t, Scope *s) {
+    uint32_t old = s->mask + 1;
+    Scope bigger = { s->base + old, old * 2 - 1, s->count };
+    uint32_t i;
+
+    reserve(t, bigger.base + old * 2);
+    memset(&t->slots[bigger.base], 0, (size_t)old * 2 * sizeof(Symbol));
+    for (i = 0; i < old; i++) {
+        const Symbol *sym = &t->slots[s->base + i];
+        if (sym->decl)
+            *probe(t, &bigger, sym->name) = *sym;
+    }
+    memmove(&t->slots[s->base], &t->slots[bigger.base], (size_t)old * 2 * sizeof(Symbol));
+    s->mask = bigger.mask;
+    t->used = s->base + old * 2;
+}
+
+// Adds name to the innermost scope. Returns NULL, or the earlier symbol if
+// the scope already declares name; that one is left in place.
+const Symbol *scope_declare(ScopeTable *t, SymbolId name, SymbolKind kind, NodeId decl) {
+    Scope *s = &t->scopes[t->depth - 1];
+    Symbol *sym = probe(t, s, name);
+
+    if (sym->decl)
+        return sym;
+    if ((s->count + 1) * 2 > s->mask + 1) {
+        scope_grow(t, s);
+        sym = probe(t, s, name);
+    }
+    sym->name = name;
+    sym->kind = kind;
+    sym->decl = decl;
+    s->count++;
+    return NULL;
+}
+
+// Innermost declaration of name in any open scope, or NULL
+const Symbol *scope_lookup(const ScopeTable *t, SymbolId name) {
+    uint32_t d;
+
+    for (d = t->depth; d > 0; d--) {
+        const Symbol *sym = probe(t, &t->scopes[d - 1], name);
+        if (sym->decl)
+            return sym;
+    }
+    return NULL;
+}
+
+const Symbol *scope_lookup_local(const ScopeTable *t, SymbolId name) {
+    const Symbol *sym;
+
+    if (t->depth == 0)
+        return NULL;
+    sym = probe(t, &t->scopes[t->depth - 1], name);
+    return sym->decl ? sym : NULL;
+}
+
+void scope_table_free(ScopeTable *t) {
+    free(t->slots);
+    free(t->scopes);
+    memset(t, 0, sizeof(*t));
+}
@@ -0,0 +1,46 @@
+#ifndef SCOPE_H
+#define SCOPE_H
+
+#include <stdint.h>
+#include "ast.h"
+#include "intern.h"
+
+typedef enum { SYM_CLASS, SYM_FIELD, SYM_METHOD, SYM_PARAM, SYM_LOCAL } SymbolKind;
+
+typedef struct {
+    SymbolId name;
+    uint32_t kind;
+    NodeId decl;            // declaring node; 0 marks an empty slot
+} Symbol;
+
+typedef struct {
+    uint32_t base;          // first slot in the slab
+    uint32_t mask;          // slot count - 1
+    uint32_t count;
+} Scope;
+
+// Names declared in nested scopes, each an open-addressing hash table.
+// Scopes are a stack, so every scope's table is a slice of one slab just
+// above its parent's: pushing takes the next slice and popping gives it
+// back. Once the slab has grown to the deepest nesting of a tree, scopes
+// come and go without touching the heap. Only the innermost scope takes
+// declarations, so it can grow in place at the top of the slab. Symbols
+// returned stay valid until the next push or declare.
+// A zero-initialized ScopeTable is ready to use.
+typedef struct {
+    Symbol *slots;
+    uint32_t used;
+    uint32_t capacity;
+    Scope *scopes;
+    uint32_t depth;
+    uint32_t max_depth;
+} ScopeTable;
+
+void scope_push(ScopeTable *t, uint32_t hint);
+void scope_pop(ScopeTable *t);
+const Symbol *scope_declare(ScopeTable *t, SymbolId name, SymbolKind kind, NodeId decl);
+const Symbol *scope_lookup(const ScopeTable *t, SymbolId name);
+const Symbol *scope_lookup_local(const ScopeTable *t, SymbolId name);
+void scope_table_free(ScopeTable *t);
+
+#endif
@@ -0,0 +1,52 @@
+#include "source.h"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+int source_map_open(SourceMap *map, const char *path) {
+    struct stat st;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char *base;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return -1;
+    if (fstat(fd, &st) < 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return -1;
+    }
+
+    map->size = (size_t)st.st_size;
+    map->map_size = (map->size + 2 + page - 1) & ~(page - 1);
+
+    // Reserve zeroed anonymous memory for the file plus the two terminating
+    // NULs, then map the file over the front of it. Bytes past EOF in the
+    // last file page read as zero, and any further page is anonymous.
+    base = mmap(NULL, map->map_size, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (base == MAP_FAILED) {
+        close(fd);
+        return -1;
+    }
+    if (map->size > 0 &&
+        mmap(base, map->size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+        munmap(base, map->map_size);
+        close(fd);
+        return -1;
+    }
+    close(fd);
+
+    madvise(base, map->map_size, MADV_SEQUENTIAL);
+    map->base = base;
+    return 0;
+}
+
+void source_map_close(SourceMap *map) {
+    if (map->base)
+        munmap(map->base, map->map_size);
+    map->base = NULL;
+    map->size = map->map_size = 0;
+}
@@ -0,0 +1,17 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stddef.h>
+
+// A source file mapped copy-on-write into memory and followed by two NUL
+// bytes, so flex can scan it in place with yy_scan_buffer.
+typedef struct {
+    char *base;
+    size_t size;
+    size_t map_size;
+} SourceMap;
+
+int source_map_open(SourceMap *map, const char *path);
+void source_map_close(SourceMap *map);
+
+#endif
@@ -0,0 +1,182 @@
+#include "stats.h"
+#include <string.h>
+#include <sys/resource.h>
+#include "context.h"
+#include "keywords.h"
+
+static const char *const phase_names[STATS_PHASES] = { "open", "lex", "parse", "check", "run", "print" };
+
+static double diff_ms(const struct timespec *from, const struct timespec *to) {
+    return (to->tv_sec - from->tv_sec) * 1e3 + (to->tv_nsec - from->tv_nsec) / 1e6;
+}
+
+void stats_init(Stats *s, clockid_t cpu_clock) {
+    memset(s, 0, sizeof(*s));
+    s->cpu_clock = cpu_clock;
+}
+
+void stats_start(const Stats *s, StatsTimer *t) {
+    clock_gettime(CLOCK_MONOTONIC, &t->wall);
+    clock_gettime(s->cpu_clock, &t->cpu);
+}
+
+void stats_stop(Stats *s, StatsPhase phase, const StatsTimer *t) {
+    struct timespec wall, cpu;
+
+    clock_gettime(CLOCK_MONOTONIC, &wall);
+    clock_gettime(s->cpu_clock, &cpu);
+    s->wall_ms[phase] += diff_ms(&t->wall, &wall);
+    s->cpu_ms[phase] += diff_ms(&t->cpu, &cpu);
+}
+
+void stats_loop_begin(const Stats *s, StatsLoop *loop) {
+    stats_start(s, &loop->start);
+    loop->mark = loop->start.wall;
+    loop->lex_ms = loop->parse_ms = 0;
+}
+
+void stats_lexed(StatsLoop *loop) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    loop->lex_ms += diff_ms(&loop->mark, &now);
+    loop->mark = now;
+}
+
+void stats_parsed(StatsLoop *loop) {
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    loop->parse_ms += diff_ms(&loop->mark, &now);
+    loop->mark = now;
+}
+
+// Time after the last step went into a token that was not finished, so it
+// counts as lexing
+void stats_loop_end(Stats *s, StatsLoop *loop) {
+    struct timespec cpu;
+    double cpu_ms, wall_ms;
+
+    stats_lexed(loop);
+    clock_gettime(s->cpu_clock, &cpu);
+    cpu_ms = diff_ms(&loop->start.cpu, &cpu);
+    wall_ms = loop->lex_ms + loop->parse_ms;
+    s->wall_ms[STATS_LEX] += loop->lex_ms;
+    s->wall_ms[STATS_PARSE] += loop->parse_ms;
+    if (wall_ms > 0) {
+        s->cpu_ms[STATS_LEX] += cpu_ms * loop->lex_ms / wall_ms;
+        s->cpu_ms[STATS_PARSE] += cpu_ms * loop->parse_ms / wall_ms;
+    }
+}
+
+// Token chunks, strings, tree and line index only grow during a parse, so
+// what they hold at the end is their peak
+void stats_note_context(Stats *s, const ParseContext *ctx) {
+    const InternPool *pool = &ctx->symbol_table.strings;
+
+    s->bytes += ctx->symbol_table.arena.allocated + pool->arena.allocated;
+    s->bytes += (size_t)pool->capacity * sizeof(InternEntry);
+    if (pool->slots)
+        s->bytes += ((size_t)pool->mask + 1) * sizeof(uint32_t);
+    s->bytes += (size_t)ctx->ast.capacity * sizeof(AstNode);
+    s->lexeme_bytes += pool->bytes_requested;
+    s->lexeme_stored += pool->bytes_stored;
+    s->bytes += ctx->lines.capacity * sizeof(uint64_t);
+    if (ctx->push)
+        s->bytes += ctx->push->capacity;
+}
+
+void stats_merge(Stats *into, const Stats *s) {
+    int i;
+
+    for (i = 0; i < STATS_PHASES; i++) {
+        into->wall_ms[i] += s->wall_ms[i];
+        into->cpu_ms[i] += s->cpu_ms[i];
+    }
+    for (i = 0; i < STATS_TOKEN_CODES; i++)
+        into->tokens[i] += s->tokens[i];
+    if (s->max_depth > into->max_depth)
+        into->max_depth = s->max_depth;
+    into->steps += s->steps;
+    into->ops += s->ops;
+    into->jitted += s->jitted;
+    into->folded += s->folded;
+    into->bytes += s->bytes;
+    into->lexeme_bytes += s->lexeme_bytes;
+    into->lexeme_stored += s->lexeme_stored;
+    into->files += s->files;
+    into->cached += s->cached;
+}
+
+static long peak_rss_kib(void) {
+    struct rusage usage;
+
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return usage.ru_maxrss;     // KiB on Linux
+}
+
+static void print_human(const Stats *s, FILE *f) {
+    double wall = 0, cpu = 0;
+    uint64_t total = 0, count;
+    int i;
+
+    fprintf(f, "%-12s %12s %12s\n", "Phase", "wall ms", "cpu ms");
+    for (i = 0; i < STATS_PHASES; i++) {
+        fprintf(f, "%-12s %12.3f %12.3f\n", phase_names[i], s->wall_ms[i], s->cpu_ms[i]);
+        wall += s->wall_ms[i];
+        cpu += s->cpu_ms[i];
+    }
+    fprintf(f, "%-12s %12.3f %12.3f\n", "total", wall, cpu);
+    fprintf(f, "\n%-12s %12s\n", "Token", "count");
+    for (i = 0; i < token_type_count; i++) {
+        count = s->tokens[token_types[i].token];
+        if (count == 0)
+            continue;
+        fprintf(f, "%-12s %12llu\n", token_types[i].name, (unsigned long long)count);
+        total += count;
+    }
+    fprintf(f, "%-12s %12llu\n", "total", (unsigned long long)total);
+    fprintf(f, "\nFiles: %zu (%zu from cache)\n", s->files, s->cached);
+    fprintf(f, "Max parser stack depth: %d\n", s->max_depth);
+    if (s->steps)
+        fprintf(f, "Statements executed: %llu\n", (unsigned long long)s->steps);
+    if (s->ops)
+        fprintf(f, "Bytecode instructions executed: %llu\n", (unsigned long long)s->ops);
+    if (s->jitted)
+        fprintf(f, "Methods compiled to machine code: %llu\n", (unsigned long long)s->jitted);
+    if (s->folded)
+        fprintf(f, "Expression nodes folded away: %llu\n", (unsigned long long)s->folded);
+    fprintf(f, "Bytes allocated: %zu\n", s->bytes);
+    fprintf(f, "Lexeme bytes: %zu, interned copies: %zu\n", s->lexeme_bytes, s->lexeme_stored);
+    fprintf(f, "Peak RSS: %ld KiB\n", peak_rss_kib());
+}
+
+static void print_json(const Stats *s, FILE *f) {
+    uint64_t total = 0, count;
+    const char *sep = "";
+    int i;
+
+    fprintf(f, "{\"files\":%zu,\"cached\":%zu,\"phases\":{", s->files, s->cached);
+    for (i = 0; i < STATS_PHASES; i++)
+        fprintf(f, "%s\"%s\":{\"wall_ms\":%.3f,\"cpu_ms\":%.3f}", i ? "," : "",
+                phase_names[i], s->wall_ms[i], s->cpu_ms[i]);
+    fprintf(f, "},\"tokens\":{");
+    for (i = 0; i < token_type_count; i++) {
+        count = s->tokens[token_types[i].token];
+        if (count == 0)
+            continue;
+        fprintf(f, "%s\"%s\":%llu", sep, token_types[i].name, (unsigned long long)count);
+        total += count;
+        sep = ",";
+    }
+    fprintf(f, "},\"token_total\":%llu,\"max_stack_depth\":%d,\"steps\":%llu,\"ops\":%llu,\"jitted\":%llu,\"folded\":%llu,\"bytes_allocated\":%zu,\"lexeme_bytes\":%zu,\"lexeme_stored\":%zu,\"peak_rss_kib\":%ld}\n",
+            (unsigned long long)total, s->max_depth, (unsigned long long)s->steps, (unsigned long long)s->ops, (unsigned long long)s->jitted, (unsigned long long)s->folded, s->bytes, s->lexeme_bytes, s->lexeme_stored, peak_rss_kib());
+}
+
+void stats_print(const Stats *s, FILE *f, int json) {
+    if (json)
+        print_json(s, f);
+    else
+        print_human(s, f);
+}
@@ -0,0 +1,59 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+struct ParseContext;
+
+typedef enum { STATS_OPEN, STATS_LEX, STATS_PARSE, STATS_CHECK, STATS_RUN, STATS_PRINT, STATS_PHASES } StatsPhase;
+
+#define STATS_TOKEN_CODES 512   // room for every bison token code
+
+// Counters for --stats, kept per file and summed over a batch
+typedef struct {
+    clockid_t cpu_clock;    // CLOCK_THREAD_CPUTIME_ID unless the file has the process to itself
+    double wall_ms[STATS_PHASES];
+    double cpu_ms[STATS_PHASES];
+    uint64_t tokens[STATS_TOKEN_CODES]; // by bison token code
+    int max_depth;          // deepest parser stack seen
+    uint64_t steps;         // statements executed by --run on the tree interpreter
+    uint64_t ops;           // bytecode instructions executed by --run
+    uint64_t jitted;        // methods --engine=jit compiled to machine code
+    uint64_t folded;        // expression nodes the fold pass removed
+    size_t bytes;           // held by the parse structures when the file was done
+    size_t lexeme_bytes;    // lexeme bytes a copy per token would have used
+    size_t lexeme_stored;   // lexeme bytes the intern pool copied
+    size_t files;
+    size_t cached;          // files reported from the cache
+} Stats;
+
+typedef struct {
+    struct timespec wall;
+    struct timespec cpu;
+} StatsTimer;
+
+// Lexing and parsing alternate token by token, too finely to read the CPU
+// clock around each step, so a loop times each step on the wall clock and
+// splits the loop's CPU time between the two in the same proportion
+typedef struct {
+    StatsTimer start;
+    struct timespec mark;   // end of the last step
+    double lex_ms;
+    double parse_ms;
+} StatsLoop;
+
+void stats_init(Stats *s, clockid_t cpu_clock);
+void stats_start(const Stats *s, StatsTimer *t);
+void stats_stop(Stats *s, StatsPhase phase, const StatsTimer *t);
+void stats_loop_begin(const Stats *s, StatsLoop *loop);
+void stats_lexed(StatsLoop *loop);
+void stats_parsed(StatsLoop *loop);
+void stats_loop_end(Stats *s, StatsLoop *loop);
+void stats_note_context(Stats *s, const struct ParseContext *ctx);
+void stats_merge(Stats *into, const Stats *s);
+void stats_print(const Stats *s, FILE *f, int json);
+
+#endif
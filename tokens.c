@@ -0,0 +1,41 @@
+#include "tokens.h"
+#include <string.h>
+
+// Append a token whose strings are already interned in ts->strings
+Token *token_store_push(TokenStore *ts, SymbolId lexeme, SymbolId type, uint64_t offset) {
+    TokenChunk *chunk = ts->tail;
+    Token *tok;
+
+    // A new chunk also starts when the offset no longer fits 32 bits
+    if (!chunk || chunk->count == TOKEN_CHUNK_SIZE || offset - chunk->base > UINT32_MAX) {
+        chunk = arena_alloc(&ts->arena, sizeof(TokenChunk));
+        chunk->next = NULL;
+        chunk->count = 0;
+        chunk->base = offset;
+        if (ts->tail)
+            ts->tail->next = chunk;
+        else
+            ts->head = chunk;
+        ts->tail = chunk;
+    }
+
+    tok = &chunk->tokens[chunk->count++];
+    tok->lexeme = lexeme;
+    tok->token_type = type;
+    tok->offset = (uint32_t)(offset - chunk->base);
+    ts->count++;
+    return tok;
+}
+
+Token *token_store_add(TokenStore *ts, const char *lexeme, size_t len,
+                       const char *type, uint64_t offset) {
+    SymbolId lexeme_id = intern(&ts->strings, lexeme, len);
+    return token_store_push(ts, lexeme_id, intern(&ts->strings, type, strlen(type)), offset);
+}
+
+void token_store_free(TokenStore *ts) {
+    arena_free(&ts->arena);
+    intern_free(&ts->strings);
+    ts->head = ts->tail = NULL;
+    ts->count = 0;
+}
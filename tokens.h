@@ -0,0 +1,44 @@
+#ifndef TOKENS_H
+#define TOKENS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "arena.h"
+#include "intern.h"
+
+#define TOKEN_CHUNK_SIZE 4096
+
+// Positions are byte offsets; LineIndex turns them into line and column
+typedef struct {
+    SymbolId lexeme;
+    SymbolId token_type;
+    uint32_t offset;        // relative to the chunk's base
+} Token;
+
+typedef struct TokenChunk {
+    struct TokenChunk *next;
+    int count;
+    uint64_t base;          // offset of the chunk's first token
+    Token tokens[TOKEN_CHUNK_SIZE];
+} TokenChunk;
+
+// Append-only token log. Tokens live in fixed-size arena chunks and refer to
+// lexemes and type names through the interned string pool.
+typedef struct {
+    Arena arena;
+    InternPool strings;
+    TokenChunk *head;
+    TokenChunk *tail;
+    size_t count;
+} TokenStore;
+
+Token *token_store_add(TokenStore *ts, const char *lexeme, size_t len,
+                       const char *type, uint64_t offset);
+Token *token_store_push(TokenStore *ts, SymbolId lexeme, SymbolId type, uint64_t offset);
+void token_store_free(TokenStore *ts);
+
+static inline uint64_t token_offset(const TokenChunk *chunk, const Token *tok) {
+    return chunk->base + tok->offset;
+}
+
+#endif
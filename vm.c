@@ -0,0 +1,412 @@
+#include "vm.h"
+#include "jit.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Bytecode engine for methods bytecode.c compiles. Each call claims
+// registers above those of the calls it is nested in, fills the
+// parameters, zeroes the other locals and copies the constants in, then
+// runs the instructions until a return. Instructions are dispatched with
+// computed goto where the compiler has labels as values (GCC, Clang), and
+// with a switch elsewhere or when built with -DVM_NO_COMPUTED_GOTO.
+//
+// Work the tree interpreter already does, and the errors that come with
+// it, is shared through runtime.h: array growth and bounds errors off the
+// fast path, member access through other objects, calls, reading and
+// writing. Any error ends the method at once; the run is halted then.
+// With --engine=jit a method that is called or loops often enough is
+// promoted to machine code (jit.c), entering at a loop head if needed.
+
+#if defined(__GNUC__) && !defined(VM_NO_COMPUTED_GOTO)
+#define VM_COMPUTED_GOTO
+#endif
+
+#define AST (&in->ctx->ast)
+#define NAME(sym) (int)intern_len(&in->ctx->symbol_table.strings, (sym)), \
+                  intern_str(&in->ctx->symbol_table.strings, (sym))
+
+static void *xcalloc(size_t n, size_t size) {
+    void *p = calloc(n ? n : 1, size);
+    if (!p) {
+        fprintf(stderr, "Error: Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+void vm_init(Interp *in) {
+    in->code = xcalloc(in->ctx->ast.count, sizeof(VmCode *));
+    in->regs = xcalloc(VM_REGS, sizeof(Word));
+}
+
+void vm_free(Interp *in) {
+    uint32_t i;
+
+    for (i = 0; i < in->ctx->ast.count; i++)
+        vm_code_free(in->code[i]);
+    free(in->code);
+    free(in->regs);
+}
+
+// Declaration of the field with the given id, for error messages
+static NodeId field_decl(Interp *in, uint32_t field) {
+    uint32_t i;
+    NodeId id;
+
+    for (i = 0; i < in->classes.count; i++) {
+        AST_FOREACH(AST, ast_at(AST, in->classes.classes[i].decl)->b, id) {
+            if (ast_at(AST, id)->kind == AST_FIELD && in->info[id] == field)
+                return id;
+        }
+    }
+    return 0;
+}
+
+static void missing_field(Interp *in, Object *self, uint32_t field, uint32_t line) {
+    interp_error(in, line, "an object of class '%.*s' has no field '%.*s'",
+                 NAME(in->classes.classes[self->cls].name), NAME(ast_at(AST, field_decl(in, field))->v.sym));
+}
+
+static int type_of_kind(int kind) {
+    return kind == VAL_FLOAT ? TYPE_FLOAT : TYPE_INTEGER;
+}
+
+// Runs a method through a call site; the result is converted to the kind
+// the caller was compiled for
+static int call(Interp *in, Object *self, const VmCallSite *site, const Word *args, Word *result, uint32_t line) {
+    const AstNode *node;
+    Object *receiver;
+    NodeId method = interp_target(in, self, site->call, &receiver);
+    uint32_t base = in->sp, nparams = 0, i;
+    Value v;
+    NodeId param;
+
+    if (!method)
+        return 0;
+    node = ast_at(AST, method);
+    AST_FOREACH(AST, node->a, param)
+        nparams++;
+    if (nparams != site->nargs) {
+        interp_error(in, line, "'%.*s' takes %u arguments", NAME(node->v.sym), nparams);
+        return 0;
+    }
+    if (base + nparams > INTERP_STACK_VALUES) {
+        interp_error(in, line, "calls nest too deeply");
+        return 0;
+    }
+    for (i = 0; i < nparams; i++) {
+        in->stack[base + i].kind = site->kinds[i];
+        in->stack[base + i].v = args[i];
+    }
+    in->sp = base + nparams;
+    v = interp_enter(in, receiver, method, in->stack + base, line);
+    in->sp = base;
+    if (in->halted)
+        return 0;
+    v = interp_convert(in, type_of_kind(site->result), v, line);
+    *result = v.v;
+    return !in->halted;
+}
+
+// Runs one of the instructions that go through the tree interpreter's
+// helpers; 0 after an error
+int vm_slow(Interp *in, const VmCode *code, Object *self, Word *R, const Insn *pc) {
+    uint32_t line = code->lines[pc - code->insns];
+    const VmCallSite *site;
+    Value *field;
+    Value v;
+    int type;
+
+    switch (pc->op) {
+    case VM_MGET:
+        field = interp_member(in, self, (NodeId)pc->k, &type);
+        if (!field)
+            return 0;
+        v = interp_convert(in, type_of_kind(pc->c), *field, line);
+        R[pc->a] = v.v;
+        break;
+    case VM_MSET:
+        field = interp_member(in, self, (NodeId)pc->k, &type);
+        if (!field)
+            return 0;
+        v.kind = (uint8_t)pc->c;
+        v.v = R[pc->b];
+        *field = interp_convert(in, type, v, line);
+        break;
+    case VM_CALL:
+        site = &code->sites[pc->k];
+        return call(in, self, site, R + site->args, &R[pc->a], line);
+    case VM_READI:
+    case VM_READF:
+        R[pc->a] = interp_read(in, pc->op == VM_READF ? TYPE_FLOAT : TYPE_INTEGER).v;
+        break;
+    default:
+        v.kind = pc->op == VM_WRITEI ? VAL_INT : pc->op == VM_WRITEF ? VAL_FLOAT : VAL_STRING;
+        if (pc->op == VM_WRITES)
+            v.v.s = (SymbolId)pc->k;
+        else
+            v.v = R[pc->a];
+        interp_write(in, v, line);
+        break;
+    }
+    return !in->halted;
+}
+
+// Element of an array off the fast path: growth, or an error
+static Word *element(Interp *in, Array *arr, int64_t row, int64_t col, int used, uint32_t line) {
+    Value *e = interp_element(in, arr, row, col, used, line);
+
+    return e ? &e->v : NULL;
+}
+
+Value vm_execute(Interp *in, VmCode *code, Object *self, const Value *args, uint32_t line) {
+    const Insn *base = code->insns;
+    const Insn *pc = base;
+    const int32_t *slot_of;
+    uint32_t frame = in->rsp;
+    uint64_t ops = 0;
+    Value result = interp_zero;
+    Word *R, *p;
+    Value v;
+    int32_t slot, entry = 0;
+    uint32_t i;
+    // backward jumps taken before the method is promoted, once it can be
+    uint32_t hot = in->jit && code->jit_state != JIT_FAILED ? JIT_HOT_LOOPS : UINT32_MAX;
+
+#ifdef VM_COMPUTED_GOTO
+    static void *const labels[] = {
+#define VM_LABEL(name) &&op_##name,
+        VM_OPS(VM_LABEL)
+#undef VM_LABEL
+    };
+#define OP(name) op_##name:
+#define NEXT do { ops++; goto *labels[pc->op]; } while (0)
+#else
+#define OP(name) case VM_##name:
+#define NEXT goto dispatch
+#endif
+#define LINE code->lines[pc - base]
+#define JUMP(cond) do { \
+        if (!(cond)) { \
+            pc++; \
+        } else if (pc->k <= pc - base && ++code->loops >= hot) { \
+            entry = pc->k; \
+            goto promote; \
+        } else { \
+            pc = base + pc->k; \
+        } \
+        NEXT; \
+    } while (0)
+#define INT_OP(expr) do { R[pc->a].i = (expr); pc++; NEXT; } while (0)
+#define FLOAT_OP(expr) do { R[pc->a].f = (expr); pc++; NEXT; } while (0)
+#define WRAP(op) (int64_t)((uint64_t)R[pc->b].i op (uint64_t)R[pc->c].i)
+
+    if (frame + code->nregs > VM_REGS) {
+        interp_error(in, line, "calls nest too deeply");
+        return result;
+    }
+    R = in->regs + frame;
+    in->rsp = frame + code->nregs;
+    for (i = 0; i < code->nparams; i++) {
+        if (code->param_kinds[i] == VAL_ARRAY) {
+            R[i] = args[i].v;
+        } else {
+            v = interp_convert(in, type_of_kind(code->param_kinds[i]), args[i], line);
+            R[i] = v.v;
+        }
+    }
+    if (in->halted)
+        goto fail;
+    // Locals a skipped declaration leaves unset read as 0 on every call
+    for (; i < code->nlocals; i++)
+        R[i].i = 0;
+    memcpy(R + code->nlocals, code->consts, code->nconsts * sizeof(Word));
+    slot_of = interp_layout(in, self->cls)->slot_of;
+    if (hot != UINT32_MAX && (code->calls >= JIT_HOT_CALLS || ++code->calls >= JIT_HOT_CALLS))
+        goto promote;
+
+#ifdef VM_COMPUTED_GOTO
+    NEXT;
+#else
+dispatch:
+    ops++;
+    switch (pc->op) {
+#endif
+    OP(MOV) R[pc->a] = R[pc->b]; pc++; NEXT;
+    OP(I2F) FLOAT_OP((double)R[pc->b].i);
+    OP(F2I) INT_OP((int64_t)R[pc->b].f);
+    // Unsigned arithmetic wraps where signed would overflow
+    OP(ADDI) INT_OP(WRAP(+));
+    OP(SUBI) INT_OP(WRAP(-));
+    OP(MULI) INT_OP(WRAP(*));
+    OP(DIVI)
+        if (R[pc->c].i == 0) {
+            interp_error(in, LINE, "division by zero");
+            goto fail;
+        }
+        INT_OP(R[pc->c].i == -1 ? (int64_t)(0 - (uint64_t)R[pc->b].i) : R[pc->b].i / R[pc->c].i);
+    OP(ADDF) FLOAT_OP(R[pc->b].f + R[pc->c].f);
+    OP(SUBF) FLOAT_OP(R[pc->b].f - R[pc->c].f);
+    OP(MULF) FLOAT_OP(R[pc->b].f * R[pc->c].f);
+    OP(DIVF) FLOAT_OP(R[pc->b].f / R[pc->c].f);
+    OP(LTI) INT_OP(R[pc->b].i < R[pc->c].i);
+    OP(GTI) INT_OP(R[pc->b].i > R[pc->c].i);
+    OP(LEI) INT_OP(R[pc->b].i <= R[pc->c].i);
+    OP(GEI) INT_OP(R[pc->b].i >= R[pc->c].i);
+    OP(EQI) INT_OP(R[pc->b].i == R[pc->c].i);
+    OP(NEI) INT_OP(R[pc->b].i != R[pc->c].i);
+    OP(LTF) INT_OP(R[pc->b].f < R[pc->c].f);
+    OP(GTF) INT_OP(R[pc->b].f > R[pc->c].f);
+    OP(LEF) INT_OP(R[pc->b].f <= R[pc->c].f);
+    OP(GEF) INT_OP(R[pc->b].f >= R[pc->c].f);
+    OP(EQF) INT_OP(R[pc->b].f == R[pc->c].f);
+    OP(NEF) INT_OP(R[pc->b].f != R[pc->c].f);
+    OP(JMP) JUMP(1);
+    OP(JZ) JUMP(R[pc->a].i == 0);
+    OP(JNZ) JUMP(R[pc->a].i != 0);
+    OP(BLTI) JUMP(R[pc->a].i < R[pc->b].i);
+    OP(BGTI) JUMP(R[pc->a].i > R[pc->b].i);
+    OP(BLEI) JUMP(R[pc->a].i <= R[pc->b].i);
+    OP(BGEI) JUMP(R[pc->a].i >= R[pc->b].i);
+    OP(BEQI) JUMP(R[pc->a].i == R[pc->b].i);
+    OP(BNEI) JUMP(R[pc->a].i != R[pc->b].i);
+    OP(GETF)
+        slot = slot_of[pc->k];
+        if (slot < 0) {
+            missing_field(in, self, (uint32_t)pc->k, LINE);
+            goto fail;
+        }
+        R[pc->a] = self->slots[slot].v;
+        pc++;
+        NEXT;
+    OP(GETA)
+        slot = slot_of[pc->k];
+        if (slot < 0) {
+            missing_field(in, self, (uint32_t)pc->k, LINE);
+            goto fail;
+        }
+        if (self->slots[slot].kind != VAL_ARRAY) {
+            interp_error(in, LINE, "'%.*s' is not an array", NAME(ast_at(AST, field_decl(in, (uint32_t)pc->k))->v.sym));
+            goto fail;
+        }
+        R[pc->a] = self->slots[slot].v;
+        pc++;
+        NEXT;
+    OP(SETFI)
+    OP(SETFF)
+        slot = slot_of[pc->k];
+        if (slot < 0) {
+            missing_field(in, self, (uint32_t)pc->k, LINE);
+            goto fail;
+        }
+        self->slots[slot].kind = pc->op == VM_SETFF ? VAL_FLOAT : VAL_INT;
+        self->slots[slot].v = R[pc->b];
+        pc++;
+        NEXT;
+    OP(AGET) {
+        Array *arr = R[pc->b].arr;
+        int64_t row = R[pc->c].i;
+
+        if (!arr->cols && (uint64_t)row < arr->rows) {
+            R[pc->a] = arr->data[row].v;
+        } else {
+            if (!(p = element(in, arr, row, 0, 1, LINE)))
+                goto fail;
+            R[pc->a] = *p;
+        }
+        pc++;
+        NEXT;
+    }
+    OP(AGET2) {
+        Array *arr = R[pc->b].arr;
+        int64_t row = R[pc->c].i, col = R[pc->k].i;
+
+        if ((uint64_t)row < arr->rows && (uint64_t)col < arr->cols) {
+            R[pc->a] = arr->data[row * arr->cols + col].v;
+        } else {
+            if (!(p = element(in, arr, row, col, 2, LINE)))
+                goto fail;
+            R[pc->a] = *p;
+        }
+        pc++;
+        NEXT;
+    }
+    OP(ASETI)
+    OP(ASETF) {
+        Array *arr = R[pc->a].arr;
+        int64_t row = R[pc->b].i;
+
+        if (!arr->cols && (uint64_t)row < arr->rows)
+            p = &arr->data[row].v;
+        else if (!(p = element(in, arr, row, 0, 1, LINE)))
+            goto fail;
+        *p = R[pc->c];
+        pc++;
+        NEXT;
+    }
+    OP(ASET2I)
+    OP(ASET2F) {
+        Array *arr = R[pc->a].arr;
+        int64_t row = R[pc->b].i, col = R[pc->c].i;
+
+        if ((uint64_t)row < arr->rows && (uint64_t)col < arr->cols)
+            p = &arr->data[row * arr->cols + col].v;
+        else if (!(p = element(in, arr, row, col, 2, LINE)))
+            goto fail;
+        *p = R[pc->k];
+        pc++;
+        NEXT;
+    }
+    OP(MGET)
+    OP(MSET)
+    OP(CALL)
+    OP(READI)
+    OP(READF)
+    OP(WRITEI)
+    OP(WRITEF)
+    OP(WRITES)
+        if (!vm_slow(in, code, self, R, pc))
+            goto fail;
+        pc++;
+        NEXT;
+    OP(RET)
+        result.kind = (uint8_t)pc->c;
+        result.v = R[pc->a];
+        goto done;
+    OP(RETV)
+        goto done;
+#ifndef VM_COMPUTED_GOTO
+    }
+#endif
+
+    // Machine code takes over at entry and runs until the method returns
+    // or it needs the interpreter for an instruction; then the VM carries
+    // on from there in the same registers
+promote:
+    if (!jit_ready(in, code)) {
+        hot = UINT32_MAX;
+        pc = base + entry;
+        NEXT;
+    }
+    entry = jit_enter(in, code, self, slot_of, R, (uint32_t)entry, &result);
+    if (entry == JIT_RETURN)
+        goto done;
+    if (entry != JIT_FAIL) {
+        pc = base + entry;
+        NEXT;
+    }
+fail:
+    result = interp_zero;
+done:
+    in->rsp = frame;
+    in->ops += ops;
+    return result;
+#undef OP
+#undef NEXT
+#undef LINE
+#undef JUMP
+#undef INT_OP
+#undef FLOAT_OP
+#undef WRAP
+}
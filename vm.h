@@ -0,0 +1,104 @@
+#ifndef VM_H
+#define VM_H
+
+#include <stdint.h>
+#include "runtime.h"
+
+#define VM_REGS (1 << 22)          // registers of all active VM calls
+#define VM_NO_REG 0xffff
+
+// Register bytecode. Operands a, b and c are registers of the current
+// frame; k is a jump target, a field id, an AST node or a further
+// register, as noted. Registers hold raw 64-bit words, so every
+// instruction is typed: I for integer, F for float.
+#define VM_OPS(X) \
+    X(MOV)      /* a = b */ \
+    X(I2F)      /* a = (float)b */ \
+    X(F2I)      /* a = (integer)b */ \
+    X(ADDI) X(SUBI) X(MULI) X(DIVI)                 /* a = b op c */ \
+    X(ADDF) X(SUBF) X(MULF) X(DIVF) \
+    X(LTI) X(GTI) X(LEI) X(GEI) X(EQI) X(NEI)       /* a = b op c, as 0 or 1 */ \
+    X(LTF) X(GTF) X(LEF) X(GEF) X(EQF) X(NEF) \
+    X(JMP)      /* go to k */ \
+    X(JZ)       /* go to k if a is 0 */ \
+    X(JNZ) \
+    X(BLTI) X(BGTI) X(BLEI) X(BGEI) X(BEQI) X(BNEI) /* go to k if a op b */ \
+    X(GETF)     /* a = field k of self */ \
+    X(GETA)     /* a = array field k of self */ \
+    X(SETFI)    /* field k of self = b */ \
+    X(SETFF) \
+    X(AGET)     /* a = array b [c] */ \
+    X(AGET2)    /* a = array b [c][register k] */ \
+    X(ASETI)    /* array a [b] = c */ \
+    X(ASETF) \
+    X(ASET2I)   /* array a [b][c] = register k */ \
+    X(ASET2F) \
+    X(MGET)     /* a = AST_MEMBER k, converted to kind c */ \
+    X(MSET)     /* AST_MEMBER k = b, of kind c */ \
+    X(CALL)     /* a = call site k */ \
+    X(READI)    /* a = next input number */ \
+    X(READF) \
+    X(WRITEI)   /* write a */ \
+    X(WRITEF) \
+    X(WRITES)   /* write AST_STRING lexeme k */ \
+    X(RET)      /* return a, of kind c */ \
+    X(RETV)     /* return nothing */
+
+typedef enum {
+#define VM_ENUM(name) VM_##name,
+    VM_OPS(VM_ENUM)
+#undef VM_ENUM
+    VM_OP_COUNT
+} VmOp;
+
+typedef struct {
+    uint16_t op;
+    uint16_t a, b, c;
+    int32_t k;
+} Insn;
+
+// Arguments of a call are in consecutive registers; they are boxed into
+// Values by kind, and the result is unboxed to the kind the caller
+// expects from the method the call resolves to at compile time
+typedef struct {
+    NodeId call;
+    uint16_t args;
+    uint16_t nargs;
+    uint8_t result;         // VAL_INT or VAL_FLOAT
+    uint8_t *kinds;         // VAL_* of each argument
+} VmCallSite;
+
+// Registers of a frame: parameters and locals in their resolve slots,
+// then the constants, then temporaries
+typedef struct VmCode {
+    NodeId method;
+    Insn *insns;
+    uint32_t *lines;        // source line of each instruction
+    uint32_t len;
+    Word *consts;
+    uint16_t nconsts;
+    uint16_t nparams;
+    uint16_t nlocals;
+    uint16_t nregs;
+    uint8_t *param_kinds;   // VAL_INT, VAL_FLOAT or VAL_ARRAY
+    uint8_t *param_types;   // TYPE_* of the elements of each array parameter
+    uint8_t *local_kinds;   // VAL_* of each parameter and local
+    VmCallSite *sites;
+    uint32_t nsites;
+    // promotion to machine code, see jit.c
+    uint32_t calls;
+    uint32_t loops;         // backward jumps taken
+    int jit_state;          // JIT_* of jit.h
+    struct JitCode *jit;
+} VmCode;
+
+void vm_init(Interp *in);
+VmCode *vm_code(Interp *in, NodeId method);
+int vm_accepts(Interp *in, const VmCode *code, const Value *args);
+VmCode *vm_compile(Interp *in, NodeId method);
+void vm_code_free(VmCode *code);
+Value vm_execute(Interp *in, VmCode *code, Object *self, const Value *args, uint32_t line);
+int vm_slow(Interp *in, const VmCode *code, Object *self, Word *R, const Insn *pc);
+void vm_free(Interp *in);
+
+#endif